@@ -0,0 +1,546 @@
+#include "../include/bigint.hpp"
+#include "../include/lazy.hpp"
+#include "../include/mpn.hpp"
+#include "../include/parallel.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <vector>
+
+namespace {
+    std::string random_digits(std::mt19937_64 &gen, size_t len) {
+        std::uniform_int_distribution<int> digit(0, 9);
+        std::string s(len, '0');
+        for (auto &c : s) {
+            c = static_cast<char>('0' + digit(gen));
+        }
+        s[0] = static_cast<char>('1' + digit(gen) % 9);
+        return s;
+    }
+
+    // average wall time of one call in microseconds
+    double measure(const std::function<void()> &fn, double budget_us = 200000) {
+        using clock = std::chrono::steady_clock;
+        size_t reps = 0;
+        auto start = clock::now();
+        double elapsed = 0;
+        do {
+            fn();
+            ++reps;
+            elapsed = std::chrono::duration<double, std::micro>(clock::now() - start).count();
+        } while (elapsed < budget_us);
+        return elapsed / static_cast<double>(reps);
+    }
+
+    struct Thresholds {
+        size_t karatsuba, toom3, ntt;
+
+        void apply() const {
+            BigInt::karatsuba_threshold = karatsuba;
+            BigInt::toom3_threshold = toom3;
+            BigInt::ntt_threshold = ntt;
+        }
+    };
+
+    void bench_multiplication() {
+        std::mt19937_64 gen(1);
+        const Thresholds defaults{BigInt::karatsuba_threshold, BigInt::toom3_threshold, BigInt::ntt_threshold};
+        const Thresholds schoolbook{SIZE_MAX, SIZE_MAX, SIZE_MAX};
+        const Thresholds ntt_only{1, 1, 1};
+
+        std::printf("multiplication, operands of 9 * limbs digits, us per product\n");
+        std::printf("%8s %14s %14s %14s\n", "limbs", "schoolbook", "ntt", "dispatch");
+        for (size_t limbs = 16; limbs <= (size_t(1) << 16); limbs *= 2) {
+            BigInt a(random_digits(gen, limbs * 9));
+            BigInt b(random_digits(gen, limbs * 9));
+            auto product = [&] {
+                BigInt c = a * b;
+            };
+            if (limbs <= 8192) {
+                schoolbook.apply();
+                std::printf("%8zu %14.1f", limbs, measure(product));
+            } else {
+                std::printf("%8zu %14s", limbs, "-");
+            }
+            ntt_only.apply();
+            double t_ntt = measure(product);
+            defaults.apply();
+            std::printf(" %14.1f %14.1f\n", t_ntt, measure(product));
+        }
+        defaults.apply();
+    }
+
+    template <class Number>
+    void bench_basecase_radix(const char *name) {
+        std::mt19937_64 gen(11);
+        const size_t karatsuba = Number::karatsuba_threshold;
+        const size_t comba = Number::comba_threshold;
+        // binary rows and columns are compared on the portable kernel, the rows on a mulx kernel get
+        // columns of their own ("-" for decimal radices and CPUs without one)
+        const mpn::kernel detected = mpn::mul_kernel();
+        const bool mulx = Number::base_digits == 0 && detected != mpn::kernel::portable;
+        // every size stays in the basecase
+        Number::karatsuba_threshold = SIZE_MAX;
+        std::printf("%s limbs\n%8s %14s %14s %14s %14s %14s %14s\n", name, "limbs", "rows", "comba",
+                    "square rows", "square comba", "mulx rows", "square mulx");
+        for (size_t limbs : {1, 2, 3, 4, 6, 8, 12, 16, 24, 32, 48, 64}) {
+            size_t digits = limbs * (Number::base_digits ? Number::base_digits : 19);
+            Number a(random_digits(gen, digits));
+            Number b(random_digits(gen, digits));
+            Number c;
+            // enough products per call to keep the clock out of the short ones
+            size_t reps = 1 + 4096 / (limbs * limbs);
+            auto time = [&](size_t threshold, auto product) {
+                Number::comba_threshold = threshold;
+                return measure([&] {
+                    for (size_t i = 0; i < reps; ++i) {
+                        c = product();
+                    }
+                }) * 1000 / static_cast<double>(reps);
+            };
+            auto multiply = [&] {
+                return a * b;
+            };
+            auto square = [&] {
+                return Number::square(a);
+            };
+            mpn::use_mul_kernel(mpn::kernel::portable);
+            std::printf("%8zu %14.1f %14.1f %14.1f %14.1f", limbs, time(SIZE_MAX, multiply), time(0, multiply),
+                        time(SIZE_MAX, square), time(0, square));
+            mpn::use_mul_kernel(detected);
+            if (mulx) {
+                std::printf(" %14.1f %14.1f\n", time(SIZE_MAX, multiply), time(SIZE_MAX, square));
+            } else {
+                std::printf(" %14s %14s\n", "-", "-");
+            }
+        }
+        Number::karatsuba_threshold = karatsuba;
+        Number::comba_threshold = comba;
+    }
+
+    void bench_basecase() {
+        std::printf("basecase multiplication of equal operands, ns per product\n");
+        bench_basecase_radix<BasicBigInt<unsigned long long, 1000000000>>("10^9");
+        bench_basecase_radix<BasicBigInt<unsigned long long, 0>>("2^64");
+    }
+
+    void bench_sort() {
+        std::mt19937_64 gen(2);
+        std::vector<BigInt> nums;
+        const size_t count = 1000000;
+        nums.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            std::string digits = random_digits(gen, 1 + gen() % 40);
+            nums.emplace_back(gen() % 2 ? "-" + digits : digits);
+        }
+
+        // the former operator<=>: print both operands and compare the text
+        auto by_text = [](const BigInt &lhs, const BigInt &rhs) {
+            std::string s1 = lhs.to_string();
+            std::string s2 = rhs.to_string();
+            bool neg1 = s1[0] == '-';
+            bool neg2 = s2[0] == '-';
+            if (neg1 != neg2) {
+                return neg1;
+            }
+            if (s1.size() != s2.size()) {
+                return (s1.size() < s2.size()) != neg1;
+            }
+            return neg1 ? s2 < s1 : s1 < s2;
+        };
+
+        std::printf("sorting %zu BigInts of 1-40 digits, ms\n", count);
+        std::vector<BigInt> copy = nums;
+        auto start = std::chrono::steady_clock::now();
+        std::sort(copy.begin(), copy.end(), by_text);
+        double t_text = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        copy = nums;
+        start = std::chrono::steady_clock::now();
+        std::sort(copy.begin(), copy.end());
+        double t_limbs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::printf("%14s %14s\n", "to_string", "limbs");
+        std::printf("%14.1f %14.1f\n", t_text, t_limbs);
+    }
+
+    // values of one or two limbs, as ledgers hold them: built, summed and sorted in a vector
+    void bench_small_values() {
+        std::mt19937_64 gen(9);
+        const size_t count = 1000000;
+        std::vector<long long> values(count);
+        for (auto &v : values) {
+            v = static_cast<long long>(gen()) >> (gen() % 40);
+        }
+        using clock = std::chrono::steady_clock;
+        auto start = clock::now();
+        std::vector<BigInt> nums(values.begin(), values.end());
+        double t_build = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        start = clock::now();
+        BigInt total;
+        for (const auto &num : nums) {
+            total += num;
+        }
+        for (auto &num : nums) {
+            num += total;
+        }
+        double t_sum = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        start = clock::now();
+        std::sort(nums.begin(), nums.end());
+        double t_sort = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        std::printf("%zu values below 2^63, ms; sizeof(BigInt) = %zu\n", count, sizeof(BigInt));
+        std::printf("%14s %14s %14s\n", "build", "sum", "sort");
+        std::printf("%14.1f %14.1f %14.1f\n", t_build, t_sum, t_sort);
+    }
+
+    void bench_to_string() {
+        std::mt19937_64 gen(5);
+        std::printf("decimal output, ms per call\n");
+        std::printf("%8s %14s %14s\n", "digits", "to_string", "to_chars");
+        for (size_t digits : {1000, 10000, 100000, 1000000}) {
+            BigInt x(random_digits(gen, digits));
+            std::string buf(digits, ' ');
+            double t_string = measure([&] {
+                x.to_string();
+            }, 1000000);
+            double t_chars = measure([&] {
+                x.to_chars(buf.data(), buf.data() + buf.size());
+            }, 1000000);
+            std::printf("%8zu %14.3f %14.3f\n", digits, t_string / 1000, t_chars / 1000);
+        }
+    }
+
+    void bench_from_chars() {
+        std::mt19937_64 gen(6);
+        std::printf("decimal input, ms per call\n");
+        std::printf("%8s %14s %14s\n", "digits", "constructor", "from_chars");
+        for (size_t digits : {1000, 10000, 100000, 1000000}) {
+            std::string str = random_digits(gen, digits);
+            BigInt x;
+            double t_string = measure([&] {
+                BigInt{str};
+            }, 1000000);
+            double t_chars = measure([&] {
+                x.from_chars(str);
+            }, 1000000);
+            std::printf("%8zu %14.3f %14.3f\n", digits, t_string / 1000, t_chars / 1000);
+        }
+
+        // one newline-separated text of many short numbers, as the loaders read them
+        const size_t count = 1000000;
+        std::string text;
+        for (size_t i = 0; i < count; ++i) {
+            text += random_digits(gen, 1 + gen() % 40);
+            text += '\n';
+        }
+        BigInt x;
+        auto start = std::chrono::steady_clock::now();
+        for (const char *p = text.data(), *last = p + text.size(); p != last; ++p) {
+            p = x.from_chars(p, last).ptr;
+        }
+        double t_text = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::printf("%zu numbers of 1-40 digits from one buffer: %.1f ms\n", count, t_text);
+    }
+
+    void bench_word_operands() {
+        std::mt19937_64 gen(8);
+        // a thousand operations per call keep the clock out of the figures
+        auto per_operation = [](const std::function<void()> &op) {
+            return measure([&] {
+                for (int i = 0; i < 1000; ++i) {
+                    op();
+                }
+            });
+        };
+        std::printf("built-in integer operands, ns per operation\n");
+        std::printf("%8s %12s %12s %12s %18s %12s %12s\n", "digits", "++x", "x += B(1)", "x * 10 + 7",
+                    "x * B(10) + B(7)", "x % 97", "x % B(97)");
+        for (size_t digits : {20, 200, 2000}) {
+            BigInt x(random_digits(gen, digits));
+            BigInt r;
+            double t_inc = per_operation([&] {
+                ++x;
+            });
+            double t_inc_big = per_operation([&] {
+                x += BigInt(1);
+            });
+            double t_mad = per_operation([&] {
+                r = x * 10 + 7;
+            });
+            double t_mad_big = per_operation([&] {
+                r = x * BigInt(10) + BigInt(7);
+            });
+            double t_mod = per_operation([&] {
+                r = x % 97;
+            });
+            double t_mod_big = per_operation([&] {
+                r = x % BigInt(97);
+            });
+            std::printf("%8zu %12.1f %12.1f %12.1f %18.1f %12.1f %12.1f\n", digits, t_inc, t_inc_big, t_mad,
+                        t_mad_big, t_mod, t_mod_big);
+        }
+    }
+
+    void bench_conversion() {
+        using Binary = BasicBigInt<unsigned long long, 0>;
+        using Decimal3 = BasicBigInt<unsigned long long, 1000>;
+        using Decimal9 = BasicBigInt<unsigned long long, 1000000000>;
+        std::mt19937_64 gen(7);
+        std::printf("change of radix, ms per call\n");
+        std::printf("%8s %14s %14s %14s %14s\n", "digits", "1e9->1e3", "via string", "1e9->2^64", "via string");
+        for (size_t digits : {1000, 10000, 100000, 1000000}) {
+            Decimal9 x(random_digits(gen, digits));
+            double t_regroup = measure([&] {
+                Decimal3{x};
+            }, 1000000);
+            double t_regroup_text = measure([&] {
+                Decimal3{x.to_string()};
+            }, 1000000);
+            double t_binary = measure([&] {
+                Binary{x};
+            }, 1000000);
+            double t_binary_text = measure([&] {
+                Binary{x.to_string()};
+            }, 1000000);
+            std::printf("%8zu %14.3f %14.3f %14.3f %14.3f\n", digits, t_regroup / 1000, t_regroup_text / 1000,
+                        t_binary / 1000, t_binary_text / 1000);
+        }
+    }
+
+    void bench_fused() {
+        std::mt19937_64 gen(9);
+        std::printf("fused expressions against the plain operators, us per expression\n");
+        std::printf("%8s %12s %12s %12s %12s %12s %12s\n", "digits", "acc += a*b", "lazy", "a * b % m", "lazy",
+                    "16-term sum", "lazy");
+        for (size_t digits : {20, 100, 1000, 10000}) {
+            BigInt a(random_digits(gen, digits));
+            BigInt b(random_digits(gen, digits));
+            BigInt m(random_digits(gen, digits));
+            BigInt acc(random_digits(gen, 2 * digits + 1));
+            std::vector<BigInt> terms;
+            for (int i = 0; i < 16; ++i) {
+                terms.emplace_back(random_digits(gen, digits));
+            }
+            BigInt r;
+            // one addition and one subtraction, so that the accumulator keeps its size
+            double t_mac = measure([&] {
+                acc += a * b;
+                acc -= a * b;
+            }) / 2;
+            double t_mac_lazy = measure([&] {
+                acc += lazy(a) * b;
+                acc -= lazy(a) * b;
+            }) / 2;
+            double t_mod = measure([&] {
+                r = a * b % m;
+            });
+            double t_mod_lazy = measure([&] {
+                r = lazy(a) * b % m;
+            });
+            double t_sum = measure([&] {
+                r = terms[0] + terms[1] - terms[2] + terms[3] - terms[4] + terms[5] - terms[6] + terms[7] -
+                    terms[8] + terms[9] - terms[10] + terms[11] - terms[12] + terms[13] - terms[14] + terms[15];
+            });
+            double t_sum_lazy = measure([&] {
+                r = lazy(terms[0]) + terms[1] - terms[2] + terms[3] - terms[4] + terms[5] - terms[6] + terms[7] -
+                    terms[8] + terms[9] - terms[10] + terms[11] - terms[12] + terms[13] - terms[14] + terms[15];
+            });
+            std::printf("%8zu %12.3f %12.3f %12.3f %12.3f %12.3f %12.3f\n", digits, t_mac, t_mac_lazy, t_mod,
+                        t_mod_lazy, t_sum, t_sum_lazy);
+        }
+    }
+
+    void bench_limb_layer() {
+        std::mt19937_64 gen(10);
+        std::printf("quotient and remainder of 2d by d digits, us per division\n");
+        std::printf("%8s %14s %14s\n", "d", "x / y, x % y", "mpn::divrem");
+        for (size_t digits : {20, 100, 1000, 10000}) {
+            BigInt x(random_digits(gen, 2 * digits));
+            BigInt y(random_digits(gen, digits));
+            BigInt q;
+            BigInt r;
+            double t_operators = measure([&] {
+                q = x / y;
+                r = x % y;
+            });
+            // the buffers are sized once and every division writes into them
+            size_t n = x.limb_count();
+            size_t m = y.limb_count();
+            std::vector<mpn::limb_t> quotient(n - m + 1);
+            std::vector<mpn::limb_t> remainder(m);
+            std::vector<mpn::limb_t> scratch(mpn::divrem_itch(n, m));
+            double t_limbs = measure([&] {
+                mpn::divrem<BigInt::base>(quotient.data(), remainder.data(), x.limbs(), n, y.limbs(), m,
+                                          scratch.data());
+            });
+            std::printf("%8zu %14.2f %14.2f\n", digits, t_operators, t_limbs);
+        }
+    }
+
+    template <mpn::limb_t Base>
+    void bench_add_kernels_radix(const char *name) {
+        std::mt19937_64 gen(11);
+        for (size_t n : {16, 64, 1000, 100000}) {
+            std::vector<mpn::limb_t> u(n);
+            std::vector<mpn::limb_t> v(n);
+            std::vector<mpn::limb_t> r(n);
+            for (size_t i = 0; i < n; ++i) {
+                u[i] = Base == 0 ? gen() : gen() % Base;
+                v[i] = Base == 0 ? gen() : gen() % Base;
+            }
+            std::printf("%6s %8zu", name, n);
+            for (auto k : {mpn::kernel::portable, mpn::kernel::avx2, mpn::kernel::avx512}) {
+                if (!mpn::supports(k)) {
+                    std::printf(" %10s", "-");
+                    continue;
+                }
+                mpn::use_add_kernel(k);
+                double t = measure([&] {
+                    mpn::add_n<Base>(r.data(), u.data(), v.data(), n);
+                    mpn::sub_n<Base>(r.data(), r.data(), v.data(), n);
+                });
+                std::printf(" %10.3f", t * 1000 / static_cast<double>(2 * n));
+            }
+            std::printf("\n");
+        }
+    }
+
+    void bench_add_kernels() {
+        mpn::kernel detected = mpn::add_kernel();
+        std::printf("mpn::add_n and sub_n on each kernel, ns per limb (bound at load: %s)\n",
+                    mpn::kernel_name(detected));
+        std::printf("%6s %8s %10s %10s %10s\n", "radix", "limbs", "portable", "avx2", "avx512");
+        bench_add_kernels_radix<1000000000>("10^9");
+        bench_add_kernels_radix<0>("2^64");
+        mpn::use_add_kernel(detected);
+    }
+
+    void bench_mul_kernels() {
+        using Binary = BasicBigInt<unsigned long long, 0>;
+        mpn::kernel detected = mpn::mul_kernel();
+        std::mt19937_64 gen(12);
+        std::printf("binary mpn::addmul_1 and products on each kernel (bound at load: %s)\n",
+                    mpn::kernel_name(detected));
+        std::printf("%8s %8s %12s %12s %12s\n", "limbs", "", "portable", "bmi2", "adx");
+        for (size_t n : {8, 32, 1000}) {
+            std::vector<mpn::limb_t> u(n);
+            std::vector<mpn::limb_t> r(n);
+            for (size_t i = 0; i < n; ++i) {
+                u[i] = gen();
+                r[i] = gen();
+            }
+            Binary a;
+            Binary b;
+            a.assign_limbs(u.data(), n);
+            b.assign_limbs(r.data(), n);
+            Binary c;
+            double t_addmul[3] = {};
+            double t_product[3] = {};
+            int i = 0;
+            for (auto k : {mpn::kernel::portable, mpn::kernel::bmi2, mpn::kernel::adx}) {
+                if (mpn::supports(k)) {
+                    mpn::use_mul_kernel(k);
+                    t_addmul[i] = measure([&] {
+                        mpn::addmul_1<0>(r.data(), u.data(), n, u[0]);
+                    }) * 1000 / static_cast<double>(n);
+                    t_product[i] = measure([&] {
+                        c = a * b;
+                    });
+                }
+                ++i;
+            }
+            std::printf("%8zu %8s %12.3f %12.3f %12.3f\n", n, "ns/limb", t_addmul[0], t_addmul[1], t_addmul[2]);
+            std::printf("%8zu %8s %12.3f %12.3f %12.3f\n", n, "us/mul", t_product[0], t_product[1], t_product[2]);
+        }
+        mpn::use_mul_kernel(detected);
+    }
+
+    void bench_threads() {
+        std::mt19937_64 gen(13);
+        size_t available = parallel::threads();
+        std::vector<size_t> counts;
+        for (size_t t = 1; t < available; t *= 2) {
+            counts.push_back(t);
+        }
+        counts.push_back(available);
+        std::printf("products of two equal operands on 1 .. %zu threads, ms per product and speedup\n", available);
+        std::printf("%10s %8s %12s %8s\n", "digits", "threads", "ms", "speedup");
+        // the low sizes bracket the crossover parallel_threshold has to sit at
+        const size_t threshold = BigInt::parallel_threshold;
+        for (size_t digits : {20000, 50000, 200000, 1000000, 10000000}) {
+            BigInt a(random_digits(gen, digits));
+            BigInt b(random_digits(gen, digits));
+            BigInt c;
+            double serial = 0;
+            // each product goes parallel at its top level, also below the default threshold, and
+            // deeper only where the default would
+            BigInt::parallel_threshold = std::min(threshold, a.limb_count());
+            for (size_t t : counts) {
+                parallel::set_threads(t);
+                double ms = measure([&] {
+                    c = a * b;
+                }, 1000000) / 1000;
+                serial = t == 1 ? ms : serial;
+                std::printf("%10zu %8zu %12.1f %8.2f\n", digits, t, ms, serial / ms);
+            }
+        }
+        BigInt::parallel_threshold = threshold;
+        parallel::set_threads(available);
+    }
+}
+
+int main(int argc, char **argv) {
+    // run every benchmark, or only the ones named on the command line
+    auto selected = [&](const char *name) {
+        if (argc < 2) {
+            return true;
+        }
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], name) == 0) {
+                return true;
+            }
+        }
+        return false;
+    };
+    if (selected("mul")) {
+        bench_multiplication();
+    }
+    if (selected("basecase")) {
+        bench_basecase();
+    }
+    if (selected("sort")) {
+        bench_sort();
+    }
+    if (selected("small")) {
+        bench_small_values();
+    }
+    if (selected("print")) {
+        bench_to_string();
+    }
+    if (selected("parse")) {
+        bench_from_chars();
+    }
+    if (selected("word")) {
+        bench_word_operands();
+    }
+    if (selected("convert")) {
+        bench_conversion();
+    }
+    if (selected("fused")) {
+        bench_fused();
+    }
+    if (selected("mpn")) {
+        bench_limb_layer();
+    }
+    if (selected("addsub")) {
+        bench_add_kernels();
+    }
+    if (selected("mulx")) {
+        bench_mul_kernels();
+    }
+    if (selected("threads")) {
+        bench_threads();
+    }
+    return 0;
+}
@@ -4,59 +4,365 @@
 #include <vector>
 #include <cmath>
 #include <iomanip>
+#include <type_traits>
+#include <cstdint>
+#include <concepts>
+#include <charconv>
+#include <string_view>
+#include "small_vector.hpp"
+
+namespace bigint_detail {
+    // limbs kept inside the number before it allocates; with four a BasicBigInt fills one 64-byte line
+    constexpr size_t inline_limbs = 4;
+
+    constexpr bool is_power_of_ten(unsigned long long b) {
+        if (b < 10) {
+            return false;
+        }
+        while (b % 10 == 0) {
+            b /= 10;
+        }
+        return b == 1;
+    }
+
+    template <class T>
+    constexpr bool is_char_v = std::is_same_v<T, char> || std::is_same_v<T, signed char> ||
+                               std::is_same_v<T, unsigned char> || std::is_same_v<T, wchar_t> ||
+                               std::is_same_v<T, char8_t> || std::is_same_v<T, char16_t> ||
+                               std::is_same_v<T, char32_t>;
+
+    // built-in integers taken as numbers; bool and the character types are left out, so that neither
+    // x + true nor x * 'a' compiles
+    template <class T>
+    concept word_operand = std::integral<T> && !std::is_same_v<T, bool> && !is_char_v<T>;
+
+    template <std::integral T>
+    constexpr bool is_negative_word(T v) {
+        if constexpr (std::is_signed_v<T>) {
+            return v < 0;
+        } else {
+            return false;
+        }
+    }
+
+    // |v| as a 64-bit word, the most negative value included
+    template <std::integral T>
+    constexpr unsigned long long word_magnitude(T v) {
+        auto magnitude = static_cast<unsigned long long>(v);
+        return is_negative_word(v) ? 0 - magnitude : magnitude;
+    }
+
+    constexpr int decimal_digits(unsigned long long b) {
+        int digits = 0;
+        for (; b > 1; b /= 10) {
+            ++digits;
+        }
+        return digits;
+    }
+}
+
+// Base is the limb radix, fixed at compile time; 0 stands for full 64-bit limbs (radix 2^64)
+template <class Limb, Limb Base>
+class BasicBigInt {
+    static_assert(std::is_same_v<Limb, unsigned long long>, "limb kernels work on 64-bit words");
+    static_assert(Base == 0 || bigint_detail::is_power_of_ten(Base), "incorrect base: should be pow of 10 or 0");
+    static_assert(Base <= 1000000000, "a product of two decimal limbs should fit into 64 bits");
 
-class BigInt {
 private:
-    unsigned long long base = 999999;
-    std::vector<unsigned long long> data;
+    template <class OtherLimb, OtherLimb OtherBase>
+    friend class BasicBigInt;
+
+    using Limbs = SmallVector<Limb, bigint_detail::inline_limbs>;
+
+    Limbs data;
     bool is_negative = false;
 
     void remove_leading_zeros();
-    static bool is_correct_string(const std::string &str);
-    void shift_left(int k);
 
-    static std::pair<BigInt, BigInt> divide(const BigInt & lhs, const BigInt & rhs);
-    void normalize();
+    void accumulate(const BasicBigInt &num, bool subtract);
+    // the same with a built-in integer of the given magnitude and sign, without a temporary
+    void accumulate_word(Limb magnitude, bool negative);
+    void multiply_word(Limb magnitude, bool negative);
+    void divide_word(Limb magnitude, bool negative);
+    void remainder_word(Limb magnitude, bool negative);
+    std::strong_ordering compare(const BasicBigInt &num) const;
+
+    static std::pair<BasicBigInt, BasicBigInt> divide(const BasicBigInt & lhs, const BasicBigInt & rhs);
 
 public:
-    BigInt();
-    BigInt(const BigInt &other);
-    BigInt(BigInt &&other) noexcept;
-    ~BigInt() = default;
+    static constexpr Limb base = Base;
+    // decimal digits per limb, 0 for binary limbs
+    static constexpr int base_digits = bigint_detail::decimal_digits(Base);
+
+    // multiplication tiers, in limbs of the shorter operand; tune per machine and radix
+    static size_t karatsuba_threshold;
+    // basecase products whose shorter operand has at least this many limbs sum each output column in
+    // 128 bits and split it once (Comba), the others go row by row with a split per partial product.
+    // Binary products only consult it on the portable kernel: while a mulx kernel is bound (see
+    // mpn::mul_kernel) they always go by rows of mpn::addmul_1, as fast as the columns when short and
+    // faster from about 32 limbs (bench basecase)
+    static size_t comba_threshold;
+    static size_t toom3_threshold;
+    static size_t ntt_threshold;
+    // products whose shorter operand has at least this many limbs run their subproducts and NTT
+    // passes side by side on the threads of parallel::set_threads. The default, some 190000 digits in
+    // either radix and deep in the NTT tier, is a safe guess rather than a measured crossover; tune it
+    // with bench threads on the target machine
+    static size_t parallel_threshold;
+    // divisors and quotients of at least this many limbs use Burnikel-Ziegler division
+    static size_t burnikel_ziegler_threshold;
 
-    explicit BigInt(long long l);
-    explicit BigInt(const std::string &in);
+    BasicBigInt();
+    BasicBigInt(const BasicBigInt &other);
+    BasicBigInt(BasicBigInt &&other) noexcept;
+    ~BasicBigInt() = default;
 
-    BigInt &operator=(const BigInt &other);
-    BigInt &operator=(BigInt &&other) noexcept;
+    explicit BasicBigInt(long long l);
+    explicit BasicBigInt(std::string_view in);
+
+    // conversion from another radix, limb by limb with no digit string in between; operands of one
+    // expression always share the radix
+    template <Limb OtherBase>
+    explicit BasicBigInt(const BasicBigInt<Limb, OtherBase> &other);
+
+    BasicBigInt &operator=(const BasicBigInt &other);
+    BasicBigInt &operator=(BasicBigInt &&other) noexcept;
 
     std::string to_string() const;
-    void reload_from_string(const std::string & in);
+    // the decimal digits into [first, last) as std::to_chars does: on success ptr is one past the last
+    // character written, if the range is too short ec is value_too_large and ptr is last
+    std::to_chars_result to_chars(char *first, char *last) const;
+    // throws std::invalid_argument unless in is an optional '-' and decimal digits, as the constructor does
+    void reload_from_string(std::string_view in);
+
+    // parses an optional '-' and the longest run of decimal digits after it as std::from_chars does:
+    // ptr is one past the last digit, or first with ec invalid_argument and *this unchanged
+    std::from_chars_result from_chars(const char *first, const char *last);
+    std::from_chars_result from_chars(std::string_view str) {
+        return from_chars(str.data(), str.data() + str.size());
+    }
+
+    friend void swap(BasicBigInt &lhs, BasicBigInt &rhs) noexcept {
+        lhs.data.swap(rhs.data);
+        std::swap(lhs.is_negative, rhs.is_negative);
+    }
+
+    friend std::ostream &operator<<(std::ostream &out, const BasicBigInt &num) {
+        out << num.to_string();
+        return out;
+    }
+
+    friend std::istream &operator>>(std::istream &in, BasicBigInt &num) {
+        std::string tmp;
+        in >> tmp;
+        num = BasicBigInt{tmp};
+        return in;
+    }
+
+    BasicBigInt operator-();
+
+    friend std::strong_ordering operator<=>(const BasicBigInt & lhs, const BasicBigInt & rhs) {
+        return lhs.compare(rhs);
+    }
+
+    friend bool operator==(const BasicBigInt & lhs, const BasicBigInt & rhs) {
+        return lhs.is_negative == rhs.is_negative && lhs.data == rhs.data;
+    }
+
+    BasicBigInt& operator++();
+    BasicBigInt operator++(int);
+    BasicBigInt& operator--();
+    BasicBigInt operator--(int);
+    BasicBigInt operator+(const BasicBigInt & num) const &;
+    BasicBigInt operator+(const BasicBigInt & num) &&;
+    BasicBigInt & operator+=(const BasicBigInt & num);
+    BasicBigInt operator-(const BasicBigInt & num) const &;
+    BasicBigInt operator-(const BasicBigInt & num) &&;
+    BasicBigInt & operator-=(const BasicBigInt & num);
+    BasicBigInt operator*(const BasicBigInt & num) const &;
+    BasicBigInt operator*(const BasicBigInt & num) &&;
+    BasicBigInt & operator*=(const BasicBigInt & num);
+    BasicBigInt operator/(const BasicBigInt & num) const &;
+    BasicBigInt operator/(const BasicBigInt & num) &&;
+    BasicBigInt & operator/=(const BasicBigInt & num);
+    BasicBigInt operator%(const BasicBigInt & num) const &;
+    BasicBigInt operator%(const BasicBigInt & num) &&;
+    BasicBigInt & operator%=(const BasicBigInt & num);
+
+    // built-in integer operands, each in one linear pass over the limbs
+    template <bigint_detail::word_operand T>
+    BasicBigInt & operator+=(T num) {
+        accumulate_word(bigint_detail::word_magnitude(num), bigint_detail::is_negative_word(num));
+        return *this;
+    }
 
-    friend std::ostream &operator<<(std::ostream &out, const BigInt &num);
-    friend std::istream &operator>>(std::istream &in, BigInt &num);
+    template <bigint_detail::word_operand T>
+    BasicBigInt & operator-=(T num) {
+        accumulate_word(bigint_detail::word_magnitude(num), !bigint_detail::is_negative_word(num));
+        return *this;
+    }
 
-    void change_base(unsigned long long new_base);
+    template <bigint_detail::word_operand T>
+    BasicBigInt & operator*=(T num) {
+        multiply_word(bigint_detail::word_magnitude(num), bigint_detail::is_negative_word(num));
+        return *this;
+    }
 
-    BigInt operator-();
-    friend std::strong_ordering operator<=>(const BigInt & lhs, const BigInt & rhs);
-    friend bool operator==(const BigInt & lhs, const BigInt & rhs);
+    template <bigint_detail::word_operand T>
+    BasicBigInt & operator/=(T num) {
+        divide_word(bigint_detail::word_magnitude(num), bigint_detail::is_negative_word(num));
+        return *this;
+    }
 
-    BigInt& operator++();
-    BigInt operator++(int);
-    BigInt& operator--();
-    BigInt operator--(int);
-    BigInt operator+(const BigInt & num) const;
-    BigInt & operator+=(const BigInt & num);
-    BigInt operator-(const BigInt & num) const;
-    BigInt & operator-=(const BigInt & num);
-    BigInt operator*(const BigInt & num) const;
-    BigInt & operator*=(const BigInt & num);
-    BigInt operator/(const BigInt & num) const;
-    BigInt & operator/=(const BigInt & num);
-    BigInt operator%(const BigInt & num) const;
-    BigInt & operator%=(const BigInt & num);
+    template <bigint_detail::word_operand T>
+    BasicBigInt & operator%=(T num) {
+        remainder_word(bigint_detail::word_magnitude(num), bigint_detail::is_negative_word(num));
+        return *this;
+    }
+
+    template <bigint_detail::word_operand T>
+    BasicBigInt operator+(T num) const & {
+        BasicBigInt tmp{*this};
+        tmp += num;
+        return tmp;
+    }
+
+    template <bigint_detail::word_operand T>
+    BasicBigInt operator+(T num) && {
+        *this += num;
+        return std::move(*this);
+    }
+
+    template <bigint_detail::word_operand T>
+    BasicBigInt operator-(T num) const & {
+        BasicBigInt tmp{*this};
+        tmp -= num;
+        return tmp;
+    }
+
+    template <bigint_detail::word_operand T>
+    BasicBigInt operator-(T num) && {
+        *this -= num;
+        return std::move(*this);
+    }
+
+    template <bigint_detail::word_operand T>
+    BasicBigInt operator*(T num) const & {
+        BasicBigInt tmp{*this};
+        tmp *= num;
+        return tmp;
+    }
+
+    template <bigint_detail::word_operand T>
+    BasicBigInt operator*(T num) && {
+        *this *= num;
+        return std::move(*this);
+    }
+
+    template <bigint_detail::word_operand T>
+    BasicBigInt operator/(T num) const & {
+        BasicBigInt tmp{*this};
+        tmp /= num;
+        return tmp;
+    }
+
+    template <bigint_detail::word_operand T>
+    BasicBigInt operator/(T num) && {
+        *this /= num;
+        return std::move(*this);
+    }
+
+    template <bigint_detail::word_operand T>
+    BasicBigInt operator%(T num) const & {
+        BasicBigInt tmp{*this};
+        tmp %= num;
+        return tmp;
+    }
+
+    template <bigint_detail::word_operand T>
+    BasicBigInt operator%(T num) && {
+        *this %= num;
+        return std::move(*this);
+    }
+
+    // the integer on the left
+    template <bigint_detail::word_operand T>
+    friend BasicBigInt operator+(T lhs, const BasicBigInt & rhs) {
+        return rhs + lhs;
+    }
+
+    template <bigint_detail::word_operand T>
+    friend BasicBigInt operator*(T lhs, const BasicBigInt & rhs) {
+        return rhs * lhs;
+    }
+
+    template <bigint_detail::word_operand T>
+    friend BasicBigInt operator-(T lhs, const BasicBigInt & rhs) {
+        BasicBigInt tmp;
+        tmp += lhs;
+        tmp -= rhs;
+        return tmp;
+    }
+
+    template <bigint_detail::word_operand T>
+    friend BasicBigInt operator/(T lhs, const BasicBigInt & rhs) {
+        BasicBigInt tmp;
+        tmp += lhs;
+        tmp /= rhs;
+        return tmp;
+    }
+
+    template <bigint_detail::word_operand T>
+    friend BasicBigInt operator%(T lhs, const BasicBigInt & rhs) {
+        BasicBigInt tmp;
+        tmp += lhs;
+        tmp %= rhs;
+        return tmp;
+    }
 
 
     bool is_null() const;
+
+    // the magnitude as limbs of the radix, lowest first and a single zero limb for zero; together with
+    // assign_limbs the bridge to the mpn functions of mpn.hpp
+    const Limb *limbs() const {
+        return data.data();
+    }
+
+    size_t limb_count() const {
+        return data.size();
+    }
+
+    // *this = [first, first + n) read as limbs of the radix, negated with negative; leading zero limbs
+    // are dropped
+    void assign_limbs(const Limb *first, size_t n, bool negative = false);
+
+    // num * num with every cross product computed once
+    static BasicBigInt square(const BasicBigInt &num);
+    static BasicBigInt pow(const BasicBigInt &base, uint64_t exp);
+
+    // fused kernels, also reached through the lazy expressions of lazy.hpp
+    // *this += lhs * rhs, or -= with subtract; short products add their rows straight into *this
+    void add_product(const BasicBigInt &lhs, const BasicBigInt &rhs, bool subtract = false);
+    // lhs * rhs % mod with the sign rules of operator%, the product buffer becoming the remainder
+    static BasicBigInt mul_mod(const BasicBigInt &lhs, const BasicBigInt &rhs, const BasicBigInt &mod);
+
+    struct Term {
+        const BasicBigInt *num;
+        bool negate;
+    };
+    // the sum of the terms, -*num for those with negate, column by column into one buffer
+    static BasicBigInt sum(const Term *terms, size_t count);
 };
+
+// the radices built into the library
+extern template class BasicBigInt<unsigned long long, 10>;
+extern template class BasicBigInt<unsigned long long, 1000>;
+extern template class BasicBigInt<unsigned long long, 1000000000>;
+extern template class BasicBigInt<unsigned long long, 0>;
+
+#ifdef BIGINT_BINARY_LIMBS
+using BigInt = BasicBigInt<unsigned long long, 0>;
+#else
+using BigInt = BasicBigInt<unsigned long long, 1000000000>;
+#endif
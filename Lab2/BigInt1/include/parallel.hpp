@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+// the worker threads that products past BasicBigInt::parallel_threshold share for their
+// subproducts and NTT transforms
+namespace parallel {
+    // threads a product may run on, the calling one included, so 1 keeps it on the caller; 0 picks
+    // std::thread::hardware_concurrency(), the default. The workers start at the first product that
+    // needs them. Not to be called while other threads use the library
+    void set_threads(size_t count);
+
+    size_t threads();
+
+    // task(0), ..., task(count - 1) on the workers and the calling thread, returning once all of them
+    // have finished; the first exception a task throws is rethrown here. Tasks may call for_each in
+    // turn, a thread that waits for its tasks runs queued ones meanwhile
+    void for_each(size_t count, const std::function<void(size_t)> &task);
+}
@@ -1,466 +1,2437 @@
 #include "../include/bigint.hpp"
+#include "../include/ntt.hpp"
+#include "../include/mpn.hpp"
+#include "../include/parallel.hpp"
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <deque>
+#include <limits>
 
-BigInt::BigInt(long long int l) : BigInt() {
+#if defined(__x86_64__) && defined(__GNUC__)
+#define BIGINT_X86_KERNELS 1
+#include <immintrin.h>
+#else
+#define BIGINT_X86_KERNELS 0
+#endif
+
+namespace {
+    __extension__ typedef unsigned __int128 uint128;
+    __extension__ typedef __int128 int128;
+
+    using Limbs = SmallVector<unsigned long long, bigint_detail::inline_limbs>;
+
+    // compile-time radix of the limb kernels; base 0 stands for full 2^64 limbs
+    template <unsigned long long B>
+    struct Radix {
+        // wide enough for a double limb plus a carry
+        using wide = std::conditional_t<B == 0, uint128, unsigned long long>;
+        using number = BasicBigInt<unsigned long long, B>;
+        static constexpr unsigned long long base = B;
+
+        static constexpr wide radix() {
+            if constexpr (B == 0) {
+                return static_cast<wide>(1) << 64;
+            } else {
+                return B;
+            }
+        }
+    };
+
+    struct SignedLimbs {
+        Limbs value;
+        bool negative = false;
+    };
+
+    void trim_limbs(Limbs &a) {
+        while (!a.empty() && a.back() == 0) {
+            a.pop_back();
+        }
+    }
+
+    int compare_limbs(const Limbs &a, const Limbs &b) {
+        if (a.size() != b.size()) {
+            return a.size() < b.size() ? -1 : 1;
+        }
+        for (size_t i = a.size(); i-- > 0;) {
+            if (a[i] != b[i]) {
+                return a[i] < b[i] ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+    Limbs slice_limbs(const Limbs &a, size_t from, size_t to) {
+        from = std::min(from, a.size());
+        to = std::min(to, a.size());
+        Limbs res(a.begin() + from, a.begin() + to);
+        trim_limbs(res);
+        return res;
+    }
+
+    // res += a with m <= n, returning the carry out of the n limbs
+    template <class R>
+    bool add_limbs(unsigned long long *res, size_t n, const unsigned long long *a, size_t m, R r) {
+        bool carry = mpn::add_n<R::base>(res, res, a, m) != 0;
+        for (size_t i = m; carry && i < n; ++i) {
+            carry = res[i] + static_cast<typename R::wide>(1) == r.radix();
+            res[i] = carry ? 0 : res[i] + 1;
+        }
+        return carry;
+    }
+
+    template <class R>
+    void sub_limbs(unsigned long long *res, size_t n, const unsigned long long *a, size_t m, R r) {
+        bool borrow = mpn::sub_n<R::base>(res, res, a, m) != 0;
+        for (size_t i = m; borrow && i < n; ++i) {
+            borrow = res[i] == 0;
+            res[i] = static_cast<unsigned long long>(borrow ? r.radix() - 1 : res[i] - 1);
+        }
+    }
+
+    // a * d for any 64-bit d; in a decimal radix a d of a limb or more multiplies in 128 bits and its
+    // carry may take several limbs
+    template <class R>
+    void multiply_limb(Limbs &a, unsigned long long d, R) {
+        if constexpr (R::base != 0) {
+            if (d >= R::base) {
+                uint128 carry = 0;
+                for (auto &limb : a) {
+                    uint128 cur = static_cast<uint128>(limb) * d + carry;
+                    limb = static_cast<unsigned long long>(cur % R::base);
+                    carry = cur / R::base;
+                }
+                for (; carry > 0; carry /= R::base) {
+                    a.push_back(static_cast<unsigned long long>(carry % R::base));
+                }
+                return;
+            }
+        }
+        if (unsigned long long carry = mpn::mul_1<R::base>(a.data(), a.data(), a.size(), d)) {
+            a.push_back(carry);
+        }
+    }
+
+    // a / d in place for any d > 0 below 2^64, returning the remainder
+    template <class R>
+    unsigned long long divide_limb(Limbs &a, unsigned long long d, R) {
+        unsigned long long rem = mpn::divrem_1<R::base>(a.data(), a.data(), a.size(), d);
+        trim_limbs(a);
+        return rem;
+    }
+
+    // a 64-bit magnitude as limbs of radix R, lowest first and none for zero; 20 is enough for
+    // decimal digits
+    template <class R>
+    struct WordLimbs {
+        std::array<unsigned long long, 20> limbs;
+        size_t size = 0;
+
+        explicit WordLimbs(unsigned long long v) {
+            if constexpr (R::base == 0) {
+                limbs[0] = v;
+                size = v != 0;
+            } else {
+                for (; v > 0; v /= R::base) {
+                    limbs[size++] = v % R::base;
+                }
+            }
+        }
+    };
+
+    // |w| > |a| for a trimmed magnitude a, {0} for zero
+    template <class R>
+    bool word_exceeds(const WordLimbs<R> &w, const Limbs &a) {
+        if (a.size() != w.size) {
+            return a.size() < w.size;
+        }
+        for (size_t i = a.size(); i-- > 0;) {
+            if (a[i] != w.limbs[i]) {
+                return a[i] < w.limbs[i];
+            }
+        }
+        return false;
+    }
+
+    template <class R>
+    void add_signed(SignedLimbs &a, const SignedLimbs &b, R r) {
+        if (a.negative == b.negative) {
+            a.value.resize(std::max(a.value.size(), b.value.size()) + 1, 0);
+            add_limbs(a.value.data(), a.value.size(), b.value.data(), b.value.size(), r);
+        } else if (compare_limbs(a.value, b.value) >= 0) {
+            sub_limbs(a.value.data(), a.value.size(), b.value.data(), b.value.size(), r);
+        } else {
+            Limbs diff = b.value;
+            sub_limbs(diff.data(), diff.size(), a.value.data(), a.value.size(), r);
+            a.value.swap(diff);
+            a.negative = b.negative;
+        }
+        trim_limbs(a.value);
+        if (a.value.empty()) {
+            a.negative = false;
+        }
+    }
+
+    template <class R>
+    void multiply(const unsigned long long *a, size_t n, const unsigned long long *b, size_t m,
+                  unsigned long long *res, R r);
+
+    template <class R>
+    void square(const unsigned long long *a, size_t n, unsigned long long *res, R r);
+
+    // a column sum of products of decimal limbs split into v / B and v % B with 64-bit divisions only;
+    // v stays below 2^64 * B, so the quotient fits a limb
+    template <class R>
+    unsigned long long split_column(uint128 v, unsigned long long &rem, R) {
+        constexpr unsigned long long word_quotient = ~0ULL / R::base + (~0ULL % R::base + 1) / R::base;
+        constexpr unsigned long long word_remainder = (~0ULL % R::base + 1) % R::base;
+        auto hi = static_cast<unsigned long long>(v >> 64);
+        auto lo = static_cast<unsigned long long>(v);
+        unsigned long long q = lo / R::base + hi * word_quotient;
+        rem = lo % R::base + hi * word_remainder;
+        q += rem / R::base;
+        rem %= R::base;
+        return q;
+    }
+
+    // binary rows run in the bound mpn::addmul_1 when it has mulx, and then keep up with the column
+    // sums when short and outrun them past about 32 limbs, so comba_threshold is not consulted
+    template <class R>
+    bool mulx_rows(R) {
+        if constexpr (R::base == 0) {
+            return mpn::mul_kernel() != mpn::kernel::portable;
+        }
+        return false;
+    }
+
+    // res += a * b one row a[i] * b at a time, every partial product split into a limb and a carry
+    template <class R>
+    void mul_rows(const unsigned long long *a, size_t n, const unsigned long long *b, size_t m,
+                  unsigned long long *res, R r) {
+        if constexpr (R::base == 0) {
+            // along the longer operand
+            if (mulx_rows(r)) {
+                for (size_t j = 0; j < m; ++j) {
+                    unsigned long long carry = mpn::addmul_1<0>(res + j, a, n, b[j]);
+                    for (size_t k = j + n; carry; ++k) {
+                        res[k] += carry;
+                        carry = res[k] < carry;
+                    }
+                }
+                return;
+            }
+        }
+        for (size_t i = 0; i < n; ++i) {
+            typename R::wide carry = 0;
+            for (size_t j = 0; j < m; ++j) {
+                typename R::wide cur = static_cast<typename R::wide>(a[i]) * b[j] + res[i + j] + carry;
+                res[i + j] = static_cast<unsigned long long>(cur % r.radix());
+                carry = cur / r.radix();
+            }
+            for (size_t j = i + m; carry; ++j) {
+                typename R::wide cur = carry + res[j];
+                res[j] = static_cast<unsigned long long>(cur % r.radix());
+                carry = cur / r.radix();
+            }
+        }
+    }
+
+    // res += a * b column by column (Comba): the products a[i] * b[k - i] of output limb k add up in
+    // 128 bits, and only the column total is split into the limb and the carry into column k + 1.
+    // Binary columns carry a third word for the overflow of the 128-bit sum
+    template <class R>
+    void mul_comba(const unsigned long long *a, size_t n, const unsigned long long *b, size_t m,
+                   unsigned long long *res, R r) {
+        if (n == 0 || m == 0) {
+            return;
+        }
+        uint128 acc = 0;
+        unsigned long long top = 0;
+        unsigned long long digit = 0;
+        for (size_t k = 0; k < n + m - 1; ++k) {
+            size_t last = std::min(k, n - 1);
+            for (size_t i = k >= m ? k - m + 1 : 0; i <= last; ++i) {
+                if constexpr (R::base == 0) {
+                    uint128 p = static_cast<uint128>(a[i]) * b[k - i];
+                    acc += p;
+                    top += acc < p;
+                } else {
+                    // a product of decimal limbs fits into 64 bits
+                    acc += a[i] * b[k - i];
+                }
+            }
+            acc += res[k];
+            if constexpr (R::base == 0) {
+                top += acc < res[k];
+                res[k] = static_cast<unsigned long long>(acc);
+                acc = (acc >> 64) | (static_cast<uint128>(top) << 64);
+                top = 0;
+            } else {
+                acc = split_column(acc, digit, r);
+                res[k] = digit;
+            }
+        }
+        // the last carry usually fits the next limb of a fresh product
+        for (size_t k = n + m - 1; acc; ++k) {
+            acc += res[k];
+            if (acc < r.radix()) {
+                res[k] = static_cast<unsigned long long>(acc);
+                break;
+            }
+            if constexpr (R::base == 0) {
+                res[k] = static_cast<unsigned long long>(acc);
+                acc >>= 64;
+            } else {
+                acc = split_column(acc, digit, r);
+                res[k] = digit;
+            }
+        }
+    }
+
+    // res += a * b for n >= m, the carry running on into limbs past n + m where res already holds some
+    template <class R>
+    void mul_basecase(const unsigned long long *a, size_t n, const unsigned long long *b, size_t m,
+                      unsigned long long *res, R r) {
+        if (m >= R::number::comba_threshold && !mulx_rows(r)) {
+            mul_comba(a, n, b, m, res, r);
+        } else {
+            mul_rows(a, n, b, m, res, r);
+        }
+    }
+
+    template <class R>
+    void sqr_rows(const unsigned long long *a, size_t n, unsigned long long *res, R r) {
+        // every cross product a[i] * a[j], i < j, once; then doubled and topped up with the squares a[i]^2
+        for (size_t i = 0; i < n; ++i) {
+            if constexpr (R::base == 0) {
+                if (mulx_rows(r)) {
+                    res[i + n] = mpn::addmul_1<0>(res + 2 * i + 1, a + i + 1, n - i - 1, a[i]);
+                    continue;
+                }
+            }
+            typename R::wide carry = 0;
+            for (size_t j = i + 1; j < n; ++j) {
+                typename R::wide cur = static_cast<typename R::wide>(a[i]) * a[j] + res[i + j] + carry;
+                res[i + j] = static_cast<unsigned long long>(cur % r.radix());
+                carry = cur / r.radix();
+            }
+            res[i + n] = static_cast<unsigned long long>(carry);
+        }
+        add_limbs(res, 2 * n, res, 2 * n, r);
+        typename R::wide carry = 0;
+        for (size_t i = 0; i < n; ++i) {
+            typename R::wide cur = static_cast<typename R::wide>(a[i]) * a[i] + res[2 * i] + carry;
+            res[2 * i] = static_cast<unsigned long long>(cur % r.radix());
+            cur = cur / r.radix() + res[2 * i + 1];
+            res[2 * i + 1] = static_cast<unsigned long long>(cur % r.radix());
+            carry = cur / r.radix();
+        }
+    }
+
+    // res = a^2 column by column: the pairs a[i] * a[k - i], i < k - i, of a column are summed once and
+    // doubled, then the square a[k / 2]^2 of an even column joins them
+    template <class R>
+    void sqr_comba(const unsigned long long *a, size_t n, unsigned long long *res, R r) {
+        if (n == 0) {
+            return;
+        }
+        uint128 carry = 0;
+        unsigned long long digit = 0;
+        for (size_t k = 0; k < 2 * n - 1; ++k) {
+            uint128 acc = 0;
+            unsigned long long top = 0;
+            for (size_t i = k >= n ? k - n + 1 : 0; 2 * i < k; ++i) {
+                if constexpr (R::base == 0) {
+                    uint128 p = static_cast<uint128>(a[i]) * a[k - i];
+                    acc += p;
+                    top += acc < p;
+                } else {
+                    acc += a[i] * a[k - i];
+                }
+            }
+            top = (top << 1) | static_cast<unsigned long long>(acc >> 127);
+            acc <<= 1;
+            if (k % 2 == 0) {
+                uint128 p = static_cast<uint128>(a[k / 2]) * a[k / 2];
+                acc += p;
+                top += acc < p;
+            }
+            acc += carry;
+            top += acc < carry;
+            if constexpr (R::base == 0) {
+                res[k] = static_cast<unsigned long long>(acc);
+                carry = (acc >> 64) | (static_cast<uint128>(top) << 64);
+            } else {
+                // decimal columns stay far below 2^128, top is zero
+                carry = split_column(acc, digit, r);
+                res[k] = digit;
+            }
+        }
+        res[2 * n - 1] = static_cast<unsigned long long>(carry);
+    }
+
+    // res = a^2 for a res of zeros
+    template <class R>
+    void sqr_basecase(const unsigned long long *a, size_t n, unsigned long long *res, R r) {
+        if (n >= R::number::comba_threshold && !mulx_rows(r)) {
+            sqr_comba(a, n, res, r);
+        } else {
+            sqr_rows(a, n, res, r);
+        }
+    }
+
+    // task(0 .. count) for the subproducts of a product whose shorter operand has m limbs, side by side
+    // on the worker threads once it reaches the parallel threshold
+    template <class R, class Task>
+    void for_each_product(size_t count, size_t m, R, const Task &task) {
+        if (m >= R::number::parallel_threshold) {
+            parallel::for_each(count, task);
+            return;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+    }
+
+    template <class R>
+    void mul_unbalanced(const unsigned long long *a, size_t n, const unsigned long long *b, size_t m,
+                        unsigned long long *res, R r) {
+        if (m >= R::number::parallel_threshold) {
+            // a group of pieces at a time, one per thread and each into a buffer of its own, then
+            // added in order
+            size_t count = (n + m - 1) / m;
+            size_t group = std::min(parallel::threads(), count);
+            std::vector<Limbs> parts(group);
+            for (size_t first = 0; first < count; first += group) {
+                size_t size = std::min(group, count - first);
+                for_each_product(size, m, r, [&](size_t j) {
+                    size_t i = (first + j) * m;
+                    size_t len = std::min(m, n - i);
+                    parts[j].assign(len + m, 0);
+                    multiply(a + i, len, b, m, parts[j].data(), r);
+                });
+                for (size_t j = 0; j < size; ++j) {
+                    size_t i = (first + j) * m;
+                    add_limbs(res + i, n + m - i, parts[j].data(), parts[j].size(), r);
+                }
+            }
+            return;
+        }
+        Limbs part(2 * m);
+        for (size_t i = 0; i < n; i += m) {
+            size_t len = std::min(m, n - i);
+            std::fill(part.begin(), part.end(), 0);
+            multiply(a + i, len, b, m, part.data(), r);
+            add_limbs(res + i, n + m - i, part.data(), len + m, r);
+        }
+    }
+
+    template <class R>
+    void mul_karatsuba(const unsigned long long *a, size_t n, const unsigned long long *b, size_t m,
+                       unsigned long long *res, R r) {
+        // a = a1 * B^k + a0, b = b1 * B^k + b0, and m > k because n < 2m
+        size_t k = n / 2;
+        Limbs sa(a + k, a + n);
+        sa.push_back(0);
+        add_limbs(sa.data(), sa.size(), a, k, r);
+        trim_limbs(sa);
+        Limbs sb(b, b + k);
+        sb.resize(std::max(k, m - k) + 1, 0);
+        add_limbs(sb.data(), sb.size(), b + k, m - k, r);
+        trim_limbs(sb);
+
+        Limbs z0(2 * k, 0);
+        Limbs z2(n + m - 2 * k, 0);
+        Limbs z1(std::max({sa.size() + sb.size(), z0.size(), z2.size()}), 0);
+        for_each_product(3, m, r, [&](size_t i) {
+            if (i == 0) {
+                multiply(a, k, b, k, z0.data(), r);
+            } else if (i == 1) {
+                multiply(a + k, n - k, b + k, m - k, z2.data(), r);
+            } else {
+                multiply(sa.data(), sa.size(), sb.data(), sb.size(), z1.data(), r);
+            }
+        });
+        sub_limbs(z1.data(), z1.size(), z0.data(), z0.size(), r);
+        sub_limbs(z1.data(), z1.size(), z2.data(), z2.size(), r);
+
+        std::copy(z0.begin(), z0.end(), res);
+        std::copy(z2.begin(), z2.end(), res + 2 * k);
+        trim_limbs(z1);
+        add_limbs(res + k, n + m - k, z1.data(), z1.size(), r);
+    }
+
+    template <class R>
+    void sqr_karatsuba(const unsigned long long *a, size_t n, unsigned long long *res, R r) {
+        // a = a1 * B^k + a0, a^2 = z2 * B^2k + (z0 + z2 - (a1 - a0)^2) * B^k + z0
+        size_t k = n / 2;
+        Limbs lo(a, a + k);
+        Limbs hi(a + k, a + n);
+        trim_limbs(lo);
+        trim_limbs(hi);
+        if (compare_limbs(lo, hi) > 0) {
+            lo.swap(hi);
+        }
+        sub_limbs(hi.data(), hi.size(), lo.data(), lo.size(), r);
+        trim_limbs(hi);
+
+        Limbs z0(2 * k, 0);
+        Limbs z2(2 * (n - k), 0);
+        Limbs d(2 * hi.size(), 0);
+        for_each_product(3, n, r, [&](size_t i) {
+            if (i == 0) {
+                square(a, k, z0.data(), r);
+            } else if (i == 1) {
+                square(a + k, n - k, z2.data(), r);
+            } else if (!hi.empty()) {
+                square(hi.data(), hi.size(), d.data(), r);
+            }
+        });
+
+        Limbs z1(z2.size() + 1, 0);
+        std::copy(z2.begin(), z2.end(), z1.begin());
+        add_limbs(z1.data(), z1.size(), z0.data(), z0.size(), r);
+        sub_limbs(z1.data(), z1.size(), d.data(), d.size(), r);
+
+        std::copy(z0.begin(), z0.end(), res);
+        std::copy(z2.begin(), z2.end(), res + 2 * k);
+        trim_limbs(z1);
+        add_limbs(res + k, 2 * n - k, z1.data(), z1.size(), r);
+    }
+
+    template <class R>
+    void mul_toom3(const unsigned long long *a, size_t n, const unsigned long long *b, size_t m,
+                   unsigned long long *res, R r) {
+        // Toom-3 with evaluation points 0, 1, -1, -2, inf and Bodrato's interpolation sequence
+        size_t k = (n + 2) / 3;
+        bool square = a == b && n == m;
+
+        auto piece = [k](const unsigned long long *x, size_t len, size_t i) {
+            size_t from = std::min(len, i * k);
+            size_t to = std::min(len, (i + 1) * k);
+            Limbs p(x + from, x + to);
+            trim_limbs(p);
+            return p;
+        };
+        auto evaluate = [&](const unsigned long long *x, size_t len, SignedLimbs *points) {
+            Limbs x0 = piece(x, len, 0);
+            Limbs x1 = piece(x, len, 1);
+            Limbs x2 = piece(x, len, 2);
+            SignedLimbs even{x0, false};
+            add_signed(even, {x2, false}, r);
+            points[0] = {x0, false};
+            points[1] = even;
+            add_signed(points[1], {x1, false}, r);
+            points[2] = even;
+            add_signed(points[2], {x1, true}, r);
+            points[3] = points[2];
+            add_signed(points[3], {x2, false}, r);
+            add_signed(points[3], points[3], r);
+            add_signed(points[3], {x0, true}, r);
+            points[4] = {x2, false};
+        };
+
+        SignedLimbs p[5];
+        SignedLimbs q[5];
+        evaluate(a, n, p);
+        if (!square) {
+            evaluate(b, m, q);
+        }
+        SignedLimbs w[5];
+        for_each_product(5, m, r, [&](size_t i) {
+            const SignedLimbs &y = square ? p[i] : q[i];
+            w[i].value.assign(p[i].value.size() + y.value.size(), 0);
+            multiply(p[i].value.data(), p[i].value.size(), y.value.data(), y.value.size(), w[i].value.data(), r);
+            w[i].negative = p[i].negative != y.negative;
+            trim_limbs(w[i].value);
+        });
+
+        // w[0] = w(0), w[1] = w(1), w[2] = w(-1), w[3] = w(-2), w[4] = w(inf)
+        SignedLimbs t3 = w[3];
+        add_signed(t3, {w[1].value, !w[1].negative}, r);
+        divide_limb(t3.value, 3, r);
+        SignedLimbs t1 = w[1];
+        add_signed(t1, {w[2].value, !w[2].negative}, r);
+        divide_limb(t1.value, 2, r);
+        SignedLimbs t2 = w[2];
+        add_signed(t2, {w[0].value, !w[0].negative}, r);
+        SignedLimbs c3 = t2;
+        add_signed(c3, {t3.value, !t3.negative}, r);
+        divide_limb(c3.value, 2, r);
+        add_signed(c3, w[4], r);
+        add_signed(c3, w[4], r);
+        add_signed(t2, t1, r);
+        add_signed(t2, {w[4].value, !w[4].negative}, r);
+        add_signed(t1, {c3.value, !c3.negative}, r);
+
+        const SignedLimbs *coefficients[5] = {&w[0], &t1, &t2, &c3, &w[4]};
+        for (size_t i = 0; i < 5; ++i) {
+            const Limbs &c = coefficients[i]->value;
+            if (c.empty()) {
+                continue;
+            }
+            add_limbs(res + i * k, n + m - i * k, c.data(), c.size(), r);
+        }
+    }
+
+    template <class R>
+    void multiply(const unsigned long long *a, size_t n, const unsigned long long *b, size_t m,
+                  unsigned long long *res, R r) {
+        if (a == b && n == m) {
+            square(a, n, res, r);
+            return;
+        }
+        if (n < m) {
+            std::swap(a, b);
+            std::swap(n, m);
+        }
+        // Karatsuba stops shrinking its operands below four limbs
+        if (m < std::max<size_t>(R::number::karatsuba_threshold, 4)) {
+            mul_basecase(a, n, b, m, res, r);
+        } else if (m >= R::number::ntt_threshold && ntt::fits(n, m, r.base)) {
+            ntt::multiply(a, n, b, m, res, r.base, m >= R::number::parallel_threshold);
+        } else if (n >= 2 * m) {
+            mul_unbalanced(a, n, b, m, res, r);
+        } else if (m < R::number::toom3_threshold) {
+            mul_karatsuba(a, n, b, m, res, r);
+        } else {
+            mul_toom3(a, n, b, m, res, r);
+        }
+    }
+
+    // res[0 .. 2n) = a^2, the same tiers as multiply with the symmetric products computed once
+    template <class R>
+    void square(const unsigned long long *a, size_t n, unsigned long long *res, R r) {
+        if (n < std::max<size_t>(R::number::karatsuba_threshold, 4)) {
+            sqr_basecase(a, n, res, r);
+        } else if (n >= R::number::ntt_threshold && ntt::fits(n, n, r.base)) {
+            ntt::multiply(a, n, a, n, res, r.base, n >= R::number::parallel_threshold);
+        } else if (n < R::number::toom3_threshold) {
+            sqr_karatsuba(a, n, res, r);
+        } else {
+            mul_toom3(a, n, a, n, res, r);
+        }
+    }
+
+    template <class R>
+    void divide_limbs(const Limbs &u, const Limbs &v,
+                      Limbs &q, Limbs &rem, R r);
+
+    template <class R>
+    void div_2n1n(const Limbs &a, const Limbs &b, size_t n,
+                  Limbs &q, Limbs &rem, R r);
+
+    template <class R>
+    void div_3n2n(const Limbs &a, const Limbs &b, size_t n,
+                  Limbs &q, Limbs &rem, R r) {
+        // a < b * B^n, b has exactly 2n limbs b1 * B^n + b2 and is normalised
+        Limbs b1 = slice_limbs(b, n, 2 * n);
+        Limbs b2 = slice_limbs(b, 0, n);
+        Limbs a12 = slice_limbs(a, n, a.size());
+
+        SignedLimbs rhat;
+        if (compare_limbs(slice_limbs(a, 2 * n, a.size()), b1) < 0) {
+            div_2n1n(a12, b1, n, q, rhat.value, r);
+        } else {
+            // the quotient limb block saturates at B^n - 1; a12 - q * b1 = a12 - b1 * B^n + b1
+            q.assign(n, static_cast<unsigned long long>(r.radix() - 1));
+            rhat.value = a12;
+            add_signed(rhat, {b1, false}, r);
+            Limbs shifted(n, 0);
+            shifted.append(b1.begin(), b1.end());
+            add_signed(rhat, {shifted, true}, r);
+        }
+
+        Limbs shifted(n, 0);
+        shifted.append(rhat.value.begin(), rhat.value.end());
+        rhat.value = shifted;
+        add_signed(rhat, {slice_limbs(a, 0, n), false}, r);
+
+        Limbs d(q.size() + b2.size(), 0);
+        multiply(q.data(), q.size(), b2.data(), b2.size(), d.data(), r);
+        trim_limbs(d);
+        add_signed(rhat, {d, true}, r);
+
+        const Limbs one{1};
+        while (rhat.negative) {
+            add_signed(rhat, {b, false}, r);
+            sub_limbs(q.data(), q.size(), one.data(), one.size(), r);
+        }
+        trim_limbs(q);
+        rem = rhat.value;
+    }
+
+    template <class R>
+    void div_2n1n(const Limbs &a, const Limbs &b, size_t n,
+                  Limbs &q, Limbs &rem, R r) {
+        // a < b * B^n, b has exactly n limbs and is normalised
+        if (n % 2 != 0 || n < R::number::burnikel_ziegler_threshold) {
+            if (a.empty()) {
+                q.clear();
+                rem.clear();
+                return;
+            }
+            divide_limbs(a, b, q, rem, r);
+            trim_limbs(q);
+            trim_limbs(rem);
+            return;
+        }
+        size_t half = n / 2;
+        Limbs q1;
+        Limbs r1;
+        div_3n2n(slice_limbs(a, half, a.size()), b, half, q1, r1, r);
+
+        Limbs next = slice_limbs(a, 0, half);
+        next.resize(half, 0);
+        next.append(r1.begin(), r1.end());
+        trim_limbs(next);
+        Limbs q2;
+        div_3n2n(next, b, half, q2, rem, r);
+
+        q = q2;
+        q.resize(half, 0);
+        q.append(q1.begin(), q1.end());
+        trim_limbs(q);
+    }
+
+    template <class R>
+    void divide_recursive(const Limbs &u, const Limbs &v,
+                          Limbs &q, Limbs &rem, R r) {
+        // Burnikel, Ziegler: Fast Recursive Division (1998). The divisor is padded to a block of
+        // j * 2^k limbs with j below the threshold and scaled so that its top limb is at least base / 2.
+        size_t n = v.size();
+        size_t levels = 0;
+        while (((n + (size_t(1) << levels) - 1) >> levels) >= R::number::burnikel_ziegler_threshold) {
+            ++levels;
+        }
+        size_t block = ((n + (size_t(1) << levels) - 1) >> levels) << levels;
+        size_t shift = block - n;
+        auto d = static_cast<unsigned long long>(r.radix() / (static_cast<typename R::wide>(v.back()) + 1));
+
+        Limbs vs(shift, 0);
+        Limbs us(shift, 0);
+        vs.append(v.begin(), v.end());
+        us.append(u.begin(), u.end());
+        us.push_back(0);
+        multiply_limb(vs, d, r);
+        multiply_limb(us, d, r);
+        trim_limbs(us);
+
+        // the top block starts with a zero limb, so it is smaller than the divisor
+        size_t t = std::max<size_t>(2, (us.size() + block) / block);
+        us.resize(t * block, 0);
+
+        q.assign((t - 1) * block, 0);
+        Limbs z(us.begin() + (t - 2) * block, us.end());
+        trim_limbs(z);
+        for (size_t i = t - 1; i-- > 0;) {
+            Limbs qi;
+            Limbs ri;
+            div_2n1n(z, vs, block, qi, ri, r);
+            std::copy(qi.begin(), qi.end(), q.begin() + i * block);
+            if (i > 0) {
+                z.assign(us.begin() + (i - 1) * block, us.begin() + i * block);
+                z.append(ri.begin(), ri.end());
+                trim_limbs(z);
+            } else {
+                rem = ri;
+            }
+        }
+
+        rem.erase_prefix(std::min(shift, rem.size()));
+        divide_limb(rem, d, r);
+        trim_limbs(q);
+        if (q.empty()) {
+            q.push_back(0);
+        }
+        if (rem.empty()) {
+            rem.push_back(0);
+        }
+    }
+
+    template <class R>
+    void divide_limbs(const Limbs &u, const Limbs &v,
+                      Limbs &q, Limbs &rem, R) {
+        // u and v carry no leading zero limbs; q takes one limb per position of the quotient
+        if (compare_limbs(u, v) < 0) {
+            q.assign(1, 0);
+            rem = u;
+            return;
+        }
+        q.resize(u.size() - v.size() + 1);
+        rem.resize(v.size());
+        // operands of up to inline_limbs limbs divide without the heap
+        SmallVector<unsigned long long, mpn::divrem_itch(bigint_detail::inline_limbs, bigint_detail::inline_limbs)>
+            scratch(mpn::divrem_itch(u.size(), v.size()));
+        mpn::divrem<R::base>(q.data(), rem.data(), u.data(), u.size(), v.data(), v.size(), scratch.data());
+        trim_limbs(rem);
+        if (rem.empty()) {
+            rem.push_back(0);
+        }
+    }
+
+    template <class R>
+    void add_magnitude(Limbs &data, const Limbs &num,
+                       R r) {
+        if (data.size() < num.size()) {
+            data.resize(num.size(), 0);
+        }
+        if (add_limbs(data.data(), data.size(), num.data(), num.size(), r)) {
+            data.push_back(1);
+        }
+    }
+
+    template <class R>
+    void sub_magnitude(Limbs &data, const Limbs &num,
+                       R r) {
+        // |data| >= |num|
+        sub_limbs(data.data(), data.size(), num.data(), num.size(), r);
+    }
+
+    template <class R>
+    void sub_magnitude_from(Limbs &data, const Limbs &num,
+                            R) {
+        // |data| < |num|, so data gets num - data
+        data.resize(num.size(), 0);
+        mpn::sub_n<R::base>(data.data(), num.data(), data.data(), num.size());
+    }
+
+    // the magnitude in 2^64 limbs, e.g. to walk over the bits of an exponent
+    template <class R>
+    Limbs binary_limbs(Limbs a, R) {
+        trim_limbs(a);
+        if constexpr (R::base == 0) {
+            return a;
+        } else {
+            // repeated short division by 2^32; rem * base + limb stays below 2^32 * base < 2^64
+            Limbs res;
+            for (size_t piece = 0; !a.empty(); ++piece) {
+                unsigned long long rem = 0;
+                for (size_t i = a.size(); i-- > 0;) {
+                    unsigned long long cur = rem * R::base + a[i];
+                    a[i] = cur >> 32;
+                    rem = cur & 0xFFFFFFFF;
+                }
+                trim_limbs(a);
+                if (piece % 2 == 0) {
+                    res.push_back(rem);
+                } else {
+                    res.back() |= rem << 32;
+                }
+            }
+            return res;
+        }
+    }
+
+    // the sliding window for an exponent of the given bit length, balancing the 2^(k-1) odd powers
+    // in the table against one multiplication per window
+    size_t window_width(size_t bits) {
+        size_t k = 1;
+        for (size_t limit : {8, 24, 80, 240, 672, 1792}) {
+            if (bits > limit) {
+                ++k;
+            }
+        }
+        return k;
+    }
+
+    // x^exp for a nonzero exp given in 2^64 limbs, scanning its bits from the top in windows of at
+    // most k bits that end in a set bit; square(a) and multiply(a, b) update a in place
+    template <class T, class Square, class Multiply>
+    T window_pow(const T &x, const Limbs &exp, Square square, Multiply multiply) {
+        auto bit = [&exp](size_t i) {
+            return exp[i / 64] >> (i % 64) & 1;
+        };
+        size_t top = exp.size() * 64 - 1;
+        while (!bit(top)) {
+            --top;
+        }
+        size_t k = window_width(top + 1);
+
+        // odd[i] = x^(2i + 1)
+        std::vector<T> odd{x};
+        if (k > 1) {
+            T x2 = x;
+            square(x2);
+            for (size_t i = 1; i < (size_t(1) << (k - 1)); ++i) {
+                T next = odd.back();
+                multiply(next, x2);
+                odd.push_back(std::move(next));
+            }
+        }
+
+        T acc = x;
+        for (size_t i = top + 1; i-- > 0;) {
+            if (!bit(i)) {
+                square(acc);
+                continue;
+            }
+            size_t j = i + 1 >= k ? i + 1 - k : 0;
+            while (!bit(j)) {
+                ++j;
+            }
+            size_t window = 0;
+            for (size_t b = i + 1; b-- > j;) {
+                window = window << 1 | bit(b);
+            }
+            if (i == top) {
+                acc = odd[window >> 1];
+            } else {
+                for (size_t b = j; b <= i; ++b) {
+                    square(acc);
+                }
+                multiply(acc, odd[window >> 1]);
+            }
+            i = j;
+        }
+        return acc;
+    }
+
+    // binary limbs are printed and parsed through chunks of this many decimal digits
+    constexpr int decimal_chunk_digits = 19;
+    constexpr unsigned long long decimal_chunk = 10000000000000000000ULL;
+
+    // binary magnitudes up to this many limbs are printed by repeated division by 10^19, longer ones
+    // are cut at P_k = 10^(19 * 2^k) into halves printed independently
+    constexpr size_t print_basecase_limbs = 24;
+
+    size_t count_digits(unsigned long long v) {
+        size_t digits = 1;
+        for (; v >= 10; v /= 10) {
+            ++digits;
+        }
+        return digits;
+    }
+
+    // P_level = 10^(19 * 2^level) in 2^64 limbs, each the square of the one before; computed once per
+    // thread and kept, a deque keeps the references valid while it grows
+    const Limbs &decimal_power(size_t level) {
+        thread_local std::deque<Limbs> powers{{decimal_chunk}};
+        while (powers.size() <= level) {
+            const Limbs &p = powers.back();
+            Limbs next(2 * p.size(), 0);
+            square(p.data(), p.size(), next.data(), Radix<0>{});
+            trim_limbs(next);
+            powers.push_back(std::move(next));
+        }
+        return powers[level];
+    }
+
+    // v as exactly width digits ending at out + width, zero-padded on the left
+    void write_digits(char *out, unsigned long long v, size_t width) {
+        for (size_t i = width; i-- > 0;) {
+            out[i] = static_cast<char>('0' + v % 10);
+            v /= 10;
+        }
+    }
+
+    // the 10^19 chunks of a binary magnitude, lowest first and at least one
+    Limbs decimal_chunks(Limbs rest) {
+        Limbs chunks;
+        trim_limbs(rest);
+        do {
+            uint128 rem = 0;
+            for (size_t i = rest.size(); i-- > 0;) {
+                uint128 cur = rem << 64 | rest[i];
+                rest[i] = static_cast<unsigned long long>(cur / decimal_chunk);
+                rem = cur % decimal_chunk;
+            }
+            trim_limbs(rest);
+            chunks.push_back(static_cast<unsigned long long>(rem));
+        } while (!rest.empty());
+        return chunks;
+    }
+
+    // x < P_level as exactly 2^level chunks of 10^19 from out on, lowest first
+    void padded_chunks(const Limbs &x, size_t level, unsigned long long *out) {
+        size_t width = size_t(1) << level;
+        if (x.size() <= print_basecase_limbs) {
+            Limbs chunks = decimal_chunks(x);
+            size_t len = std::min(width, chunks.size());
+            std::copy(chunks.begin(), chunks.begin() + len, out);
+            std::fill(out + len, out + width, 0);
+            return;
+        }
+        Limbs q;
+        Limbs rem;
+        divide_limbs(x, decimal_power(level - 1), q, rem, Radix<0>{});
+        trim_limbs(q);
+        trim_limbs(rem);
+        padded_chunks(rem, level - 1, out);
+        padded_chunks(q, level - 1, out + width / 2);
+    }
+
+    // the 10^19 chunks of a binary magnitude, lowest first, the top one nonzero unless it is the only
+    // one. Long magnitudes go by divide and conquer (subquadratic with Burnikel-Ziegler division): the
+    // leading quotient is split off first, so that the chunk count is known before any is written,
+    // and every remainder below P_k takes 2^k chunks
+    Limbs to_decimal_chunks(const Limbs &data) {
+        Limbs head = data;
+        trim_limbs(head);
+        // the split starts at the last power that may still not exceed the number
+        size_t levels = 0;
+        if (head.size() > print_basecase_limbs) {
+            for (levels = 1; 2 * decimal_power(levels - 1).size() - 1 <= head.size();) {
+                ++levels;
+            }
+        }
+        std::vector<std::pair<Limbs, size_t>> tails;
+        size_t length = 0;
+        for (size_t level = levels; level-- > 0 && head.size() > print_basecase_limbs;) {
+            if (compare_limbs(head, decimal_power(level)) < 0) {
+                continue;
+            }
+            Limbs q;
+            Limbs rem;
+            divide_limbs(head, decimal_power(level), q, rem, Radix<0>{});
+            trim_limbs(q);
+            trim_limbs(rem);
+            tails.emplace_back(std::move(rem), level);
+            head = std::move(q);
+            length += size_t(1) << level;
+        }
+        Limbs chunks(length);
+        // the remainder split off first is the least significant
+        unsigned long long *out = chunks.data();
+        for (const auto &[rem, level] : tails) {
+            padded_chunks(rem, level, out);
+            out += size_t(1) << level;
+        }
+        Limbs top = decimal_chunks(head);
+        chunks.append(top.begin(), top.end());
+        return chunks;
+    }
+
+    // the 2^64 limbs of n chunks of 10^19 at c, lowest first, by multiply-and-add up to
+    // print_basecase_limbs chunks and by splitting at P_k above
+    Limbs from_decimal_chunks(const unsigned long long *c, size_t n) {
+        Limbs res;
+        if (n <= print_basecase_limbs) {
+            for (size_t i = n; i-- > 0;) {
+                uint128 carry = c[i];
+                for (auto &limb : res) {
+                    uint128 cur = static_cast<uint128>(limb) * decimal_chunk + carry;
+                    limb = static_cast<unsigned long long>(cur);
+                    carry = cur >> 64;
+                }
+                if (carry != 0) {
+                    res.push_back(static_cast<unsigned long long>(carry));
+                }
+            }
+            return res;
+        }
+        // the low part takes 2^level chunks, at least as many as the high part
+        size_t level = 0;
+        while ((size_t(1) << (level + 1)) < n) {
+            ++level;
+        }
+        size_t low = size_t(1) << level;
+        Limbs hi = from_decimal_chunks(c + low, n - low);
+        Limbs lo = from_decimal_chunks(c, low);
+        const Limbs &power = decimal_power(level);
+        if (!hi.empty()) {
+            res.assign(hi.size() + power.size(), 0);
+            multiply(hi.data(), hi.size(), power.data(), power.size(), res.data(), Radix<0>{});
+        }
+        add_magnitude(res, lo, Radix<0>{});
+        trim_limbs(res);
+        return res;
+    }
+
+    // writes the decimal digits of a magnitude into reserve(length), length being exact; reserve may
+    // return nullptr to refuse. Binary limbs are printed through their 10^19 chunks
+    template <class R, class Reserve>
+    void print_magnitude(const Limbs &data, R, Reserve reserve) {
+        if constexpr (R::base == 0) {
+            Limbs chunks = to_decimal_chunks(data);
+            size_t top = count_digits(chunks.back());
+            char *out = reserve(top + decimal_chunk_digits * (chunks.size() - 1));
+            if (out == nullptr) {
+                return;
+            }
+            write_digits(out, chunks.back(), top);
+            out += top;
+            for (size_t i = chunks.size() - 1; i-- > 0; out += decimal_chunk_digits) {
+                write_digits(out, chunks[i], decimal_chunk_digits);
+            }
+        } else {
+            constexpr size_t digits = bigint_detail::decimal_digits(R::base);
+            size_t top = count_digits(data.back());
+            char *out = reserve(top + digits * (data.size() - 1));
+            if (out == nullptr) {
+                return;
+            }
+            write_digits(out, data.back(), top);
+            out += top;
+            for (size_t i = data.size() - 1; i-- > 0; out += digits) {
+                write_digits(out, data[i], digits);
+            }
+        }
+    }
+
+    // the end of the run of decimal digits starting at p, eight characters at a time (SWAR): a byte
+    // is a digit when neither adding 0x46 nor subtracting 0x30 sets its top bit
+    const char *skip_digits(const char *p, const char *last) {
+        for (; last - p >= 8; p += 8) {
+            uint64_t x;
+            std::memcpy(&x, p, 8);
+            if (((x + 0x4646464646464646) | (x - 0x3030303030303030)) & 0x8080808080808080) {
+                break;
+            }
+        }
+        while (p != last && *p >= '0' && *p <= '9') {
+            ++p;
+        }
+        return p;
+    }
+
+    // eight validated digits at p, first the most significant; the bytes are combined pairwise in
+    // three multiplications
+    uint32_t parse_eight_digits(const char *p) {
+        uint64_t x;
+        std::memcpy(&x, p, 8);
+        x -= 0x3030303030303030;
+        x = x * 10 + (x >> 8);
+        x = ((x & 0x000000FF000000FF) * 0x000F424000000064 + ((x >> 16) & 0x000000FF000000FF) * 0x0000271000000001)
+            >> 32;
+        return static_cast<uint32_t>(x);
+    }
+
+    // the value of n <= 19 validated digits at p
+    unsigned long long parse_digits(const char *p, size_t n) {
+        unsigned long long v = 0;
+        if constexpr (std::endian::native == std::endian::little) {
+            for (; n >= 8; p += 8, n -= 8) {
+                v = v * 100000000 + parse_eight_digits(p);
+            }
+        }
+        for (; n > 0; ++p, --n) {
+            v = v * 10 + static_cast<unsigned long long>(*p - '0');
+        }
+        return v;
+    }
+
+    // the 2^64 limbs of the len validated digits at p, subquadratic like printing
+    Limbs parse_binary(const char *p, size_t len) {
+        Limbs chunks((len + decimal_chunk_digits - 1) / decimal_chunk_digits);
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            size_t end = len - decimal_chunk_digits * i;
+            size_t n = std::min<size_t>(end, decimal_chunk_digits);
+            chunks[i] = parse_digits(p + end - n, n);
+        }
+        return from_decimal_chunks(chunks.data(), chunks.size());
+    }
+
+    constexpr unsigned long long power_of_ten(size_t n) {
+        unsigned long long p = 1;
+        for (; n > 0; --n) {
+            p *= 10;
+        }
+        return p;
+    }
+
+    // limbs of From decimal digits each regrouped into limbs of To <= 19 digits, lowest first: whole
+    // limbs are combined or split when one width divides the other, otherwise a limb is cut where
+    // the output limb fills up
+    template <size_t From, size_t To>
+    Limbs regroup_decimal(const Limbs &src) {
+        Limbs res;
+        if constexpr (To % From == 0) {
+            constexpr size_t k = To / From;
+            res.reserve((src.size() + k - 1) / k);
+            for (size_t i = 0; i < src.size(); i += k) {
+                unsigned long long v = 0;
+                for (size_t j = std::min(src.size(), i + k); j-- > i;) {
+                    v = v * power_of_ten(From) + src[j];
+                }
+                res.push_back(v);
+            }
+        } else if constexpr (From % To == 0) {
+            res.reserve(src.size() * (From / To));
+            for (unsigned long long limb : src) {
+                for (size_t j = 0; j < From / To; ++j) {
+                    res.push_back(limb % power_of_ten(To));
+                    limb /= power_of_ten(To);
+                }
+            }
+        } else {
+            res.reserve(src.size() * From / To + 1);
+            unsigned long long acc = 0;
+            size_t filled = 0;
+            for (unsigned long long limb : src) {
+                for (size_t left = From; left > 0;) {
+                    size_t take = std::min(left, To - filled);
+                    acc += limb % power_of_ten(take) * power_of_ten(filled);
+                    limb /= power_of_ten(take);
+                    left -= take;
+                    filled += take;
+                    if (filled == To) {
+                        res.push_back(acc);
+                        acc = 0;
+                        filled = 0;
+                    }
+                }
+            }
+            if (filled > 0) {
+                res.push_back(acc);
+            }
+        }
+        trim_limbs(res);
+        return res;
+    }
+
+    // a magnitude in radix From rewritten in radix To without going through its digits: decimal
+    // limbs are regrouped, and binary ones pass through 10^19 chunks by divide and conquer
+    template <class From, class To>
+    Limbs convert_limbs(const Limbs &data, From, To) {
+        constexpr size_t from_digits = bigint_detail::decimal_digits(From::base);
+        constexpr size_t to_digits = bigint_detail::decimal_digits(To::base);
+        if constexpr (From::base == To::base) {
+            return data;
+        } else if constexpr (From::base == 0) {
+            return regroup_decimal<decimal_chunk_digits, to_digits>(to_decimal_chunks(data));
+        } else if constexpr (To::base == 0) {
+            Limbs chunks = regroup_decimal<from_digits, decimal_chunk_digits>(data);
+            return from_decimal_chunks(chunks.data(), chunks.size());
+        } else {
+            return regroup_decimal<from_digits, to_digits>(data);
+        }
+    }
+}
+
+namespace mpn {
+    namespace {
+        // the portable loops, carrying into and out of a span so that the vector kernels can hand
+        // them their tails
+        template <limb_t Base>
+        limb_t add_nc(limb_t *rp, const limb_t *up, const limb_t *vp, size_t n, limb_t carry_in) {
+            using R = Radix<Base>;
+            if constexpr (Base == 0) {
+                // two 64-bit additions with their overflow flags instead of 128-bit sums
+                bool carry = carry_in != 0;
+                for (size_t i = 0; i < n; ++i) {
+                    limb_t cur;
+                    bool first = __builtin_add_overflow(up[i], vp[i], &cur);
+                    bool second = __builtin_add_overflow(cur, limb_t{carry}, &rp[i]);
+                    carry = first || second;
+                }
+                return carry;
+            }
+            typename R::wide carry = carry_in;
+            for (size_t i = 0; i < n; ++i) {
+                typename R::wide cur = carry + up[i] + vp[i];
+                carry = cur >= R::radix();
+                rp[i] = static_cast<limb_t>(carry ? cur - R::radix() : cur);
+            }
+            return static_cast<limb_t>(carry);
+        }
+
+        template <limb_t Base>
+        limb_t sub_nc(limb_t *rp, const limb_t *up, const limb_t *vp, size_t n, limb_t borrow_in) {
+            using R = Radix<Base>;
+            if constexpr (Base == 0) {
+                bool borrow = borrow_in != 0;
+                for (size_t i = 0; i < n; ++i) {
+                    limb_t cur;
+                    bool first = __builtin_sub_overflow(up[i], vp[i], &cur);
+                    bool second = __builtin_sub_overflow(cur, limb_t{borrow}, &rp[i]);
+                    borrow = first || second;
+                }
+                return borrow;
+            }
+            typename R::wide borrow = borrow_in;
+            for (size_t i = 0; i < n; ++i) {
+                typename R::wide sub = borrow + vp[i];
+                borrow = up[i] < sub;
+                rp[i] = static_cast<limb_t>(borrow ? up[i] + R::radix() - sub : up[i] - sub);
+            }
+            return static_cast<limb_t>(borrow);
+        }
+
+        template <limb_t Base>
+        limb_t mul_1c(limb_t *rp, const limb_t *up, size_t n, limb_t v, limb_t carry_in) {
+            using R = Radix<Base>;
+            typename R::wide carry = carry_in;
+            for (size_t i = 0; i < n; ++i) {
+                typename R::wide cur = static_cast<typename R::wide>(up[i]) * v + carry;
+                rp[i] = static_cast<limb_t>(cur % R::radix());
+                carry = cur / R::radix();
+            }
+            return static_cast<limb_t>(carry);
+        }
+
+        template <limb_t Base>
+        limb_t addmul_1c(limb_t *rp, const limb_t *up, size_t n, limb_t v, limb_t carry_in) {
+            using R = Radix<Base>;
+            typename R::wide carry = carry_in;
+            for (size_t i = 0; i < n; ++i) {
+                typename R::wide cur = static_cast<typename R::wide>(up[i]) * v + rp[i] + carry;
+                rp[i] = static_cast<limb_t>(cur % R::radix());
+                carry = cur / R::radix();
+            }
+            return static_cast<limb_t>(carry);
+        }
+
+        template <limb_t Base>
+        limb_t add_n_portable(limb_t *rp, const limb_t *up, const limb_t *vp, size_t n) {
+            return add_nc<Base>(rp, up, vp, n, 0);
+        }
+
+        template <limb_t Base>
+        limb_t sub_n_portable(limb_t *rp, const limb_t *up, const limb_t *vp, size_t n) {
+            return sub_nc<Base>(rp, up, vp, n, 0);
+        }
+
+        limb_t mul_1_portable(limb_t *rp, const limb_t *up, size_t n, limb_t v) {
+            return mul_1c<0>(rp, up, n, v, 0);
+        }
+
+        limb_t addmul_1_portable(limb_t *rp, const limb_t *up, size_t n, limb_t v) {
+            return addmul_1c<0>(rp, up, n, v, 0);
+        }
+
+#if BIGINT_X86_KERNELS
+        // The vector kernels add a block of lanes at once and then settle its carries the way a
+        // carry-lookahead adder does, on bit masks with a lane per bit: a lane generates a carry
+        // when its own sum overflows, and propagates one when the sum is the largest limb (the
+        // smallest for a borrow). Adding the propagate mask to the generated carries ripples each
+        // of them through its run of propagating lanes in one integer addition. Returns the lanes
+        // that take a carry and leaves the carry out of the block in carry
+        inline unsigned resolve_carries(unsigned generate, unsigned propagate, unsigned &carry, int lanes) {
+            unsigned start = generate << 1 | carry;
+            unsigned in = (start + propagate) ^ propagate;
+            carry = in >> lanes & 1;
+            return in & ((1u << lanes) - 1);
+        }
+
+        // AVX2 has only signed 64-bit comparisons: a decimal limb sum stays below 2^63, binary limbs
+        // are compared with their sign bits flipped
+        template <limb_t Base>
+        [[gnu::target("avx2")]] __m256i less_than_avx2(__m256i a, __m256i b) {
+            if constexpr (Base == 0) {
+                const __m256i sign = _mm256_set1_epi64x(std::numeric_limits<long long>::min());
+                return _mm256_cmpgt_epi64(_mm256_xor_si256(b, sign), _mm256_xor_si256(a, sign));
+            } else {
+                return _mm256_cmpgt_epi64(b, a);
+            }
+        }
+
+        [[gnu::target("avx2")]] inline unsigned lane_mask_avx2(__m256i lanes) {
+            return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(lanes)));
+        }
+
+        // all ones in the lanes whose bit is set in mask
+        [[gnu::target("avx2")]] inline __m256i lanes_of_avx2(unsigned mask) {
+            const __m256i bits = _mm256_setr_epi64x(1, 2, 4, 8);
+            return _mm256_cmpeq_epi64(_mm256_and_si256(_mm256_set1_epi64x(mask), bits), bits);
+        }
+
+        template <limb_t Base>
+        [[gnu::target("avx2")]] limb_t add_n_avx2(limb_t *rp, const limb_t *up, const limb_t *vp, size_t n) {
+            const __m256i radix = _mm256_set1_epi64x(static_cast<long long>(Base));
+            const __m256i top = _mm256_set1_epi64x(static_cast<long long>(Base - 1));
+            unsigned carry = 0;
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4) {
+                __m256i u = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(up + i));
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(vp + i));
+                __m256i sum = _mm256_add_epi64(u, v);
+                __m256i generate;
+                if constexpr (Base == 0) {
+                    generate = less_than_avx2<Base>(sum, u);
+                } else {
+                    generate = less_than_avx2<Base>(top, sum);
+                    sum = _mm256_sub_epi64(sum, _mm256_and_si256(generate, radix));
+                }
+                __m256i propagate = _mm256_cmpeq_epi64(sum, top);
+                unsigned in = resolve_carries(lane_mask_avx2(generate), lane_mask_avx2(propagate), carry, 4);
+                // lanes of all ones subtract -1
+                sum = _mm256_sub_epi64(sum, lanes_of_avx2(in));
+                if constexpr (Base != 0) {
+                    // a propagating lane that took a carry reached the radix
+                    sum = _mm256_andnot_si256(_mm256_cmpeq_epi64(sum, radix), sum);
+                }
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(rp + i), sum);
+            }
+            return add_nc<Base>(rp + i, up + i, vp + i, n - i, carry);
+        }
+
+        template <limb_t Base>
+        [[gnu::target("avx2")]] limb_t sub_n_avx2(limb_t *rp, const limb_t *up, const limb_t *vp, size_t n) {
+            const __m256i radix = _mm256_set1_epi64x(static_cast<long long>(Base));
+            const __m256i ones = _mm256_set1_epi64x(-1);
+            unsigned borrow = 0;
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4) {
+                __m256i u = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(up + i));
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(vp + i));
+                __m256i diff = _mm256_sub_epi64(u, v);
+                __m256i generate = less_than_avx2<Base>(u, v);
+                if constexpr (Base != 0) {
+                    diff = _mm256_add_epi64(diff, _mm256_and_si256(generate, radix));
+                }
+                __m256i propagate = _mm256_cmpeq_epi64(diff, _mm256_setzero_si256());
+                unsigned in = resolve_carries(lane_mask_avx2(generate), lane_mask_avx2(propagate), borrow, 4);
+                diff = _mm256_add_epi64(diff, lanes_of_avx2(in));
+                if constexpr (Base != 0) {
+                    // a propagating lane that gave a borrow wrapped to all ones instead of the radix - 1
+                    diff = _mm256_add_epi64(diff, _mm256_and_si256(_mm256_cmpeq_epi64(diff, ones), radix));
+                }
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(rp + i), diff);
+            }
+            return sub_nc<Base>(rp + i, up + i, vp + i, n - i, borrow);
+        }
+
+        // AVX-512 compares unsigned lanes into mask registers and adds under a mask, so the same
+        // steps take a few instructions per 8 limbs
+        template <limb_t Base>
+        [[gnu::target("avx512f")]] limb_t add_n_avx512(limb_t *rp, const limb_t *up, const limb_t *vp, size_t n) {
+            const __m512i radix = _mm512_set1_epi64(static_cast<long long>(Base));
+            const __m512i top = _mm512_set1_epi64(static_cast<long long>(Base - 1));
+            const __m512i one = _mm512_set1_epi64(1);
+            unsigned carry = 0;
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                __m512i u = _mm512_loadu_si512(up + i);
+                __m512i sum = _mm512_add_epi64(u, _mm512_loadu_si512(vp + i));
+                __mmask8 generate;
+                if constexpr (Base == 0) {
+                    generate = _mm512_cmplt_epu64_mask(sum, u);
+                } else {
+                    generate = _mm512_cmpgt_epu64_mask(sum, top);
+                    sum = _mm512_mask_sub_epi64(sum, generate, sum, radix);
+                }
+                __mmask8 propagate = _mm512_cmpeq_epi64_mask(sum, top);
+                unsigned in = resolve_carries(generate, propagate, carry, 8);
+                sum = _mm512_mask_add_epi64(sum, static_cast<__mmask8>(in), sum, one);
+                if constexpr (Base != 0) {
+                    sum = _mm512_mask_sub_epi64(sum, static_cast<__mmask8>(in & propagate), sum, radix);
+                }
+                _mm512_storeu_si512(rp + i, sum);
+            }
+            return add_nc<Base>(rp + i, up + i, vp + i, n - i, carry);
+        }
+
+        template <limb_t Base>
+        [[gnu::target("avx512f")]] limb_t sub_n_avx512(limb_t *rp, const limb_t *up, const limb_t *vp, size_t n) {
+            const __m512i radix = _mm512_set1_epi64(static_cast<long long>(Base));
+            const __m512i one = _mm512_set1_epi64(1);
+            unsigned borrow = 0;
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                __m512i u = _mm512_loadu_si512(up + i);
+                __m512i v = _mm512_loadu_si512(vp + i);
+                __m512i diff = _mm512_sub_epi64(u, v);
+                __mmask8 generate = _mm512_cmplt_epu64_mask(u, v);
+                if constexpr (Base != 0) {
+                    diff = _mm512_mask_add_epi64(diff, generate, diff, radix);
+                }
+                __mmask8 propagate = _mm512_testn_epi64_mask(diff, diff);
+                unsigned in = resolve_carries(generate, propagate, borrow, 8);
+                diff = _mm512_mask_sub_epi64(diff, static_cast<__mmask8>(in), diff, one);
+                if constexpr (Base != 0) {
+                    diff = _mm512_mask_add_epi64(diff, static_cast<__mmask8>(in & propagate), diff, radix);
+                }
+                _mm512_storeu_si512(rp + i, diff);
+            }
+            return sub_nc<Base>(rp + i, up + i, vp + i, n - i, borrow);
+        }
+
+        // The binary row kernels in assembly, four limbs per pass after a head of n % 4 in C. mulx
+        // multiplies by the v in rdx without touching the flags, and the loop steps its pointers with
+        // lea and its count in rcx with jrcxz, which leave them alone as well, so the carries of a row
+        // chain through the flags from the first limb to the last
+        limb_t mul_1_bmi2(limb_t *rp, const limb_t *up, size_t n, limb_t v) {
+            size_t head = n % 4;
+            limb_t carry = mul_1c<0>(rp, up, head, v, 0);
+            size_t count = n - head;
+            if (count == 0) {
+                return carry;
+            }
+            rp += head;
+            up += head;
+            limb_t lo;
+            limb_t next;
+            __asm__ volatile(
+                    "clc\n\t"
+                    "1:\n\t"
+                    "mulxq (%[up]), %[lo], %[next]\n\t"
+                    "adcq %[hi], %[lo]\n\t"
+                    "movq %[lo], (%[rp])\n\t"
+                    "mulxq 8(%[up]), %[lo], %[hi]\n\t"
+                    "adcq %[next], %[lo]\n\t"
+                    "movq %[lo], 8(%[rp])\n\t"
+                    "mulxq 16(%[up]), %[lo], %[next]\n\t"
+                    "adcq %[hi], %[lo]\n\t"
+                    "movq %[lo], 16(%[rp])\n\t"
+                    "mulxq 24(%[up]), %[lo], %[hi]\n\t"
+                    "adcq %[next], %[lo]\n\t"
+                    "movq %[lo], 24(%[rp])\n\t"
+                    "leaq 32(%[up]), %[up]\n\t"
+                    "leaq 32(%[rp]), %[rp]\n\t"
+                    "leaq -4(%[n]), %[n]\n\t"
+                    "jrcxz 2f\n\t"
+                    "jmp 1b\n"
+                    "2:\n\t"
+                    "adcq $0, %[hi]"
+                    : [rp] "+r"(rp), [up] "+r"(up), [n] "+c"(count), [hi] "+r"(carry), [lo] "=&r"(lo),
+                      [next] "=&r"(next)
+                    : "d"(v)
+                    : "cc", "memory");
+            return carry;
+        }
+
+        // without ADX a row has a single carry flag, so every limb folds its two additions into the
+        // high word before the next one
+        limb_t addmul_1_bmi2(limb_t *rp, const limb_t *up, size_t n, limb_t v) {
+            size_t head = n % 4;
+            limb_t carry = addmul_1c<0>(rp, up, head, v, 0);
+            size_t count = n - head;
+            if (count == 0) {
+                return carry;
+            }
+            rp += head;
+            up += head;
+            limb_t lo;
+            limb_t next;
+            __asm__ volatile(
+                    "1:\n\t"
+                    "mulxq (%[up]), %[lo], %[next]\n\t"
+                    "addq %[hi], %[lo]\n\t"
+                    "adcq $0, %[next]\n\t"
+                    "addq %[lo], (%[rp])\n\t"
+                    "adcq $0, %[next]\n\t"
+                    "mulxq 8(%[up]), %[lo], %[hi]\n\t"
+                    "addq %[next], %[lo]\n\t"
+                    "adcq $0, %[hi]\n\t"
+                    "addq %[lo], 8(%[rp])\n\t"
+                    "adcq $0, %[hi]\n\t"
+                    "mulxq 16(%[up]), %[lo], %[next]\n\t"
+                    "addq %[hi], %[lo]\n\t"
+                    "adcq $0, %[next]\n\t"
+                    "addq %[lo], 16(%[rp])\n\t"
+                    "adcq $0, %[next]\n\t"
+                    "mulxq 24(%[up]), %[lo], %[hi]\n\t"
+                    "addq %[next], %[lo]\n\t"
+                    "adcq $0, %[hi]\n\t"
+                    "addq %[lo], 24(%[rp])\n\t"
+                    "adcq $0, %[hi]\n\t"
+                    "leaq 32(%[up]), %[up]\n\t"
+                    "leaq 32(%[rp]), %[rp]\n\t"
+                    "subq $4, %[n]\n\t"
+                    "jnz 1b"
+                    : [rp] "+r"(rp), [up] "+r"(up), [n] "+r"(count), [hi] "+r"(carry), [lo] "=&r"(lo),
+                      [next] "=&r"(next)
+                    : "d"(v)
+                    : "cc", "memory");
+            return carry;
+        }
+
+        // ADX adds two independent carry chains, adcx through CF and adox through OF: one takes the
+        // high word of the previous product into the low word of this one, the other adds that into
+        // rp, and neither waits for the other
+        limb_t addmul_1_adx(limb_t *rp, const limb_t *up, size_t n, limb_t v) {
+            size_t head = n % 4;
+            limb_t carry = addmul_1c<0>(rp, up, head, v, 0);
+            size_t count = n - head;
+            if (count == 0) {
+                return carry;
+            }
+            rp += head;
+            up += head;
+            limb_t lo;
+            limb_t next;
+            __asm__ volatile(
+                    "xorl %k[lo], %k[lo]\n\t"
+                    "1:\n\t"
+                    "mulxq (%[up]), %[lo], %[next]\n\t"
+                    "adoxq %[hi], %[lo]\n\t"
+                    "adcxq (%[rp]), %[lo]\n\t"
+                    "movq %[lo], (%[rp])\n\t"
+                    "mulxq 8(%[up]), %[lo], %[hi]\n\t"
+                    "adoxq %[next], %[lo]\n\t"
+                    "adcxq 8(%[rp]), %[lo]\n\t"
+                    "movq %[lo], 8(%[rp])\n\t"
+                    "mulxq 16(%[up]), %[lo], %[next]\n\t"
+                    "adoxq %[hi], %[lo]\n\t"
+                    "adcxq 16(%[rp]), %[lo]\n\t"
+                    "movq %[lo], 16(%[rp])\n\t"
+                    "mulxq 24(%[up]), %[lo], %[hi]\n\t"
+                    "adoxq %[next], %[lo]\n\t"
+                    "adcxq 24(%[rp]), %[lo]\n\t"
+                    "movq %[lo], 24(%[rp])\n\t"
+                    "leaq 32(%[up]), %[up]\n\t"
+                    "leaq 32(%[rp]), %[rp]\n\t"
+                    "leaq -4(%[n]), %[n]\n\t"
+                    "jrcxz 2f\n\t"
+                    "jmp 1b\n"
+                    "2:\n\t"
+                    // both chains end in the high word, which has room for them
+                    "movl $0, %k[lo]\n\t"
+                    "adoxq %[lo], %[hi]\n\t"
+                    "adcxq %[lo], %[hi]"
+                    : [rp] "+r"(rp), [up] "+r"(up), [n] "+c"(count), [hi] "+r"(carry), [lo] "=&r"(lo),
+                      [next] "=&r"(next)
+                    : "d"(v)
+                    : "cc", "memory");
+            return carry;
+        }
+#endif
+
+        using AddFn = limb_t (*)(limb_t *, const limb_t *, const limb_t *, size_t);
+
+        // the bound kernels, portable until the CPU has been asked
+        template <limb_t Base>
+        AddFn add_n_bound = add_n_portable<Base>;
+        template <limb_t Base>
+        AddFn sub_n_bound = sub_n_portable<Base>;
+        kernel add_kernel_bound = kernel::portable;
+
+        template <limb_t Base>
+        void bind_add_kernel(kernel k) {
+#if BIGINT_X86_KERNELS
+            if (k == kernel::avx512) {
+                add_n_bound<Base> = add_n_avx512<Base>;
+                sub_n_bound<Base> = sub_n_avx512<Base>;
+                return;
+            }
+            if (k == kernel::avx2) {
+                add_n_bound<Base> = add_n_avx2<Base>;
+                sub_n_bound<Base> = sub_n_avx2<Base>;
+                return;
+            }
+#endif
+            add_n_bound<Base> = add_n_portable<Base>;
+            sub_n_bound<Base> = sub_n_portable<Base>;
+        }
+
+        // spans shorter than this stay on the portable loop, inlined into the caller
+        constexpr size_t vector_min_limbs = 16;
+
+        using MulFn = limb_t (*)(limb_t *, const limb_t *, size_t, limb_t);
+
+        // binary limbs only: a decimal row spends its time dividing by the radix, not multiplying
+        MulFn mul_1_bound = mul_1_portable;
+        MulFn addmul_1_bound = addmul_1_portable;
+        kernel mul_kernel_bound = kernel::portable;
+
+        const bool add_kernel_detected = [] {
+            use_add_kernel(supports(kernel::avx512) ? kernel::avx512
+                           : supports(kernel::avx2) ? kernel::avx2
+                                                    : kernel::portable);
+            return true;
+        }();
+
+        const bool mul_kernel_detected = [] {
+            use_mul_kernel(supports(kernel::adx) ? kernel::adx
+                           : supports(kernel::bmi2) ? kernel::bmi2
+                                                    : kernel::portable);
+            return true;
+        }();
+    }
+
+    bool supports(kernel k) {
+        switch (k) {
+            case kernel::portable:
+                return true;
+#if BIGINT_X86_KERNELS
+            case kernel::avx2:
+                __builtin_cpu_init();
+                return __builtin_cpu_supports("avx2");
+            case kernel::avx512:
+                __builtin_cpu_init();
+                return __builtin_cpu_supports("avx512f");
+            case kernel::bmi2:
+                __builtin_cpu_init();
+                return __builtin_cpu_supports("bmi2");
+            case kernel::adx:
+                __builtin_cpu_init();
+                return __builtin_cpu_supports("bmi2") && __builtin_cpu_supports("adx");
+#endif
+            default:
+                return false;
+        }
+    }
+
+    const char *kernel_name(kernel k) {
+        switch (k) {
+            case kernel::avx2:
+                return "avx2";
+            case kernel::avx512:
+                return "avx512";
+            case kernel::bmi2:
+                return "bmi2";
+            case kernel::adx:
+                return "adx";
+            default:
+                return "portable";
+        }
+    }
+
+    kernel add_kernel() {
+        return add_kernel_bound;
+    }
+
+    void use_add_kernel(kernel k) {
+        if (k == kernel::bmi2 || k == kernel::adx) {
+            throw std::invalid_argument("not an addition kernel");
+        }
+        if (!supports(k)) {
+            throw std::invalid_argument("kernel not supported by this CPU");
+        }
+        bind_add_kernel<10>(k);
+        bind_add_kernel<1000>(k);
+        bind_add_kernel<1000000000>(k);
+        bind_add_kernel<0>(k);
+        add_kernel_bound = k;
+    }
+
+    kernel mul_kernel() {
+        return mul_kernel_bound;
+    }
+
+    void use_mul_kernel(kernel k) {
+        if (k == kernel::avx2 || k == kernel::avx512) {
+            throw std::invalid_argument("not a multiplication kernel");
+        }
+        if (!supports(k)) {
+            throw std::invalid_argument("kernel not supported by this CPU");
+        }
+        mul_1_bound = mul_1_portable;
+        addmul_1_bound = addmul_1_portable;
+#if BIGINT_X86_KERNELS
+        if (k != kernel::portable) {
+            mul_1_bound = mul_1_bmi2;
+            addmul_1_bound = k == kernel::adx ? addmul_1_adx : addmul_1_bmi2;
+        }
+#endif
+        mul_kernel_bound = k;
+    }
+
+    template <limb_t Base>
+    limb_t add_n(limb_t *rp, const limb_t *up, const limb_t *vp, size_t n) {
+        if (n < vector_min_limbs) {
+            return add_nc<Base>(rp, up, vp, n, 0);
+        }
+        return add_n_bound<Base>(rp, up, vp, n);
+    }
+
+    template <limb_t Base>
+    limb_t sub_n(limb_t *rp, const limb_t *up, const limb_t *vp, size_t n) {
+        if (n < vector_min_limbs) {
+            return sub_nc<Base>(rp, up, vp, n, 0);
+        }
+        return sub_n_bound<Base>(rp, up, vp, n);
+    }
+
+    template <limb_t Base>
+    limb_t mul_1(limb_t *rp, const limb_t *up, size_t n, limb_t v) {
+        if constexpr (Base == 0) {
+            return mul_1_bound(rp, up, n, v);
+        }
+        return mul_1c<Base>(rp, up, n, v, 0);
+    }
+
+    template <limb_t Base>
+    limb_t addmul_1(limb_t *rp, const limb_t *up, size_t n, limb_t v) {
+        if constexpr (Base == 0) {
+            return addmul_1_bound(rp, up, n, v);
+        }
+        return addmul_1c<Base>(rp, up, n, v, 0);
+    }
+
+    template <limb_t Base>
+    void mul(limb_t *rp, const limb_t *up, size_t un, const limb_t *vp, size_t vn) {
+        std::fill(rp, rp + un + vn, 0);
+        multiply(up, un, vp, vn, rp, Radix<Base>{});
+    }
+
+    template <limb_t Base>
+    limb_t divrem_1(limb_t *qp, const limb_t *up, size_t n, limb_t d) {
+        using R = Radix<Base>;
+        if constexpr (Base != 0) {
+            // in a decimal radix the running remainder takes 128 bits once rem * B no longer fits into 64
+            if (d > std::numeric_limits<limb_t>::max() / Base) {
+                uint128 rem = 0;
+                for (size_t i = n; i-- > 0;) {
+                    uint128 cur = rem * Base + up[i];
+                    qp[i] = static_cast<limb_t>(cur / d);
+                    rem = cur % d;
+                }
+                return static_cast<limb_t>(rem);
+            }
+        }
+        typename R::wide rem = 0;
+        for (size_t i = n; i-- > 0;) {
+            typename R::wide cur = rem * R::radix() + up[i];
+            qp[i] = static_cast<limb_t>(cur / d);
+            rem = cur % d;
+        }
+        return static_cast<limb_t>(rem);
+    }
+
+    template <limb_t Base>
+    void divrem(limb_t *qp, limb_t *rp, const limb_t *up, size_t un, const limb_t *dp, size_t dn,
+                limb_t *scratch) {
+        using R = Radix<Base>;
+        using wide = typename R::wide;
+        const wide radix = R::radix();
+        if (dn >= R::number::burnikel_ziegler_threshold && un - dn >= R::number::burnikel_ziegler_threshold) {
+            Limbs u(up, up + un);
+            Limbs v(dp, dp + dn);
+            trim_limbs(u);
+            Limbs q;
+            Limbs rem;
+            divide_recursive(u, v, q, rem, R{});
+            std::fill(std::copy(q.begin(), q.end(), qp), qp + un - dn + 1, 0);
+            std::fill(std::copy(rem.begin(), rem.end(), rp), rp + dn, 0);
+            return;
+        }
+        if (dn == 1) {
+            rp[0] = divrem_1<Base>(qp, up, un, dp[0]);
+            return;
+        }
+
+        // Knuth, TAOCP vol. 2, 4.3.1, Algorithm D, scaled so that the top divisor limb is at least base / 2
+        auto d = static_cast<limb_t>(radix / (static_cast<wide>(dp[dn - 1]) + 1));
+        limb_t *u = scratch;
+        limb_t *v = scratch + un + 1;
+        u[un] = mul_1<Base>(u, up, un, d);
+        mul_1<Base>(v, dp, dn, d);
+
+        for (size_t j = un - dn + 1; j-- > 0;) {
+            wide top = u[j + dn] * radix + u[j + dn - 1];
+            wide qhat = top / v[dn - 1];
+            wide rhat = top % v[dn - 1];
+            while (qhat >= radix || qhat * v[dn - 2] > rhat * radix + u[j + dn - 2]) {
+                --qhat;
+                rhat += v[dn - 1];
+                if (rhat >= radix) {
+                    break;
+                }
+            }
+
+            wide borrow = 0;
+            wide carry = 0;
+            for (size_t i = 0; i < dn; ++i) {
+                wide p = qhat * v[i] + carry;
+                carry = p / radix;
+                wide sub = p % radix + borrow;
+                borrow = u[i + j] < sub;
+                u[i + j] = static_cast<limb_t>(borrow ? u[i + j] + radix - sub : u[i + j] - sub);
+            }
+            wide sub = carry + borrow;
+            if (u[j + dn] >= sub) {
+                u[j + dn] = static_cast<limb_t>(u[j + dn] - sub);
+            } else {
+                // qhat was one too large: add the divisor back, the final carry cancels the borrow
+                u[j + dn] = static_cast<limb_t>(u[j + dn] + radix - sub);
+                --qhat;
+                limb_t back = add_n<Base>(u + j, u + j, v, dn);
+                u[j + dn] = static_cast<limb_t>((u[j + dn] + back) % radix);
+            }
+            qp[j] = static_cast<limb_t>(qhat);
+        }
+        divrem_1<Base>(rp, u, dn, d);
+    }
+}
+
+template <class Limb, Limb Base>
+BasicBigInt<Limb, Base>::BasicBigInt(long long int l) : BasicBigInt() {
     if (l == 0) {
         return;
     }
+    // negate in unsigned arithmetic so that LLONG_MIN keeps its magnitude
+    auto magnitude = static_cast<unsigned long long>(l);
     if (l < 0) {
         is_negative = true;
-        l *= -1;
+        magnitude = 0 - magnitude;
     }
     data.pop_back();
-    while (l > 0) {
-        data.push_back(l % base);
-        l /= base;
+    if constexpr (Base == 0) {
+        data.push_back(magnitude);
+    } else {
+        while (magnitude > 0) {
+            data.push_back(magnitude % Base);
+            magnitude /= Base;
+        }
     }
 } // LCOV_EXCL_LINE
 
-BigInt::BigInt(const std::string &in) : BigInt() {
+template <class Limb, Limb Base>
+BasicBigInt<Limb, Base>::BasicBigInt(std::string_view in) : BasicBigInt() {
     reload_from_string(in);
 }
 
-
-std::ostream &operator<<(std::ostream &out, const BigInt &num) {
-    out << num.to_string();
-    return out;
+template <class Limb, Limb Base>
+template <Limb OtherBase>
+BasicBigInt<Limb, Base>::BasicBigInt(const BasicBigInt<Limb, OtherBase> &other)
+    : data(convert_limbs(other.data, Radix<OtherBase>{}, Radix<Base>{})), is_negative(other.is_negative) {
+    remove_leading_zeros();
 }
 
-void BigInt::remove_leading_zeros() {
+template <class Limb, Limb Base>
+void BasicBigInt<Limb, Base>::remove_leading_zeros() {
+    if (data.empty()) {
+        data.push_back(0);
+    }
+    while (data.size() > 1 && data.back() == 0) {
+        data.pop_back();
+    }
     if (is_null() && is_negative) {
         is_negative = false;
     }
-    for (int i = data.size() - 1; i > 0; --i) {
-        if (data[i] == 0) {
-            data.pop_back();
-        } else {
-            return;
-        }
-    }
 }
 
-std::string BigInt::to_string() const {
-    std::stringstream output;
-    if (is_negative) {
-        output << "-";
-    }
-    auto len_base = (int) log10l(base);
-    for (int i = data.size() - 1; i >= 0; --i) {
-        if ((size_t) i != data.size() - 1) {
-            output << std::setw(len_base) << std::setfill('0') << data[i];
-        } else {
-            output << data[i];
+template <class Limb, Limb Base>
+std::string BasicBigInt<Limb, Base>::to_string() const {
+    std::string res;
+    print_magnitude(data, Radix<Base>{}, [&](size_t length) {
+        res.resize(length + is_negative);
+        if (is_negative) {
+            res[0] = '-';
         }
-    }
-    std::string s;
-    output >> s;
-    return s;
+        return res.data() + is_negative;
+    });
+    return res;
 }
 
-std::istream &operator>>(std::istream &in, BigInt &num) {
-    std::string tmp;
-    in >> tmp;
-    num = BigInt{tmp};
-    return in;
+template <class Limb, Limb Base>
+std::to_chars_result BasicBigInt<Limb, Base>::to_chars(char *first, char *last) const {
+    std::to_chars_result res{last, std::errc::value_too_large};
+    print_magnitude(data, Radix<Base>{}, [&](size_t length) -> char * {
+        if (static_cast<size_t>(last - first) < length + is_negative) {
+            return nullptr;
+        }
+        if (is_negative) {
+            *first = '-';
+        }
+        res = {first + is_negative + length, std::errc{}};
+        return first + is_negative;
+    });
+    return res;
 }
 
-BigInt &BigInt::operator=(const BigInt &other) {
+template <class Limb, Limb Base>
+BasicBigInt<Limb, Base> &BasicBigInt<Limb, Base>::operator=(const BasicBigInt &other) {
     is_negative = other.is_negative;
-    base = other.base;
-    data.resize(other.data.size());
-    std::copy(other.data.begin(), other.data.end(), data.begin());
+    // a copy that spills gets one spare limb, so that a carry into it needs no second allocation
+    if (other.data.size() > data.capacity()) {
+        data.reserve(other.data.size() + 1);
+    }
+    data.assign(other.data.begin(), other.data.end());
     return *this;
 }
 
-BigInt &BigInt::operator=(BigInt &&other) noexcept {
+template <class Limb, Limb Base>
+BasicBigInt<Limb, Base> &BasicBigInt<Limb, Base>::operator=(BasicBigInt &&other) noexcept {
     if (this != &other) {
-        *this = other;
-        other.data.clear();
+        data = std::move(other.data);
+        is_negative = other.is_negative;
+        other.data.assign(1, 0);
         other.is_negative = false;
     }
     return *this;
 }
-
-BigInt::BigInt(BigInt &&other) noexcept: BigInt() {
-    if (this != &other) {
-        std::swap(this->data, other.data);
-        std::swap(this->is_negative, other.is_negative);
-        std::swap(this->base, other.base);
-    }
+template <class Limb, Limb Base>
+BasicBigInt<Limb, Base>::BasicBigInt(BasicBigInt &&other) noexcept
+    : data(std::move(other.data)), is_negative(other.is_negative) {
+    // the moved-from number is left as zero
+    other.data.assign(1, 0);
+    other.is_negative = false;
 }
 
-BigInt::BigInt(const BigInt &other) : BigInt() {
+template <class Limb, Limb Base>
+BasicBigInt<Limb, Base>::BasicBigInt(const BasicBigInt &other) : BasicBigInt() {
     if (this != &other) {
         *this = other;
     }
 }
 
-bool BigInt::is_correct_string(const std::string &str) {
-    for (size_t i = 0; i < str.size(); ++i) {
-        if ((str[i] < '0' || str[i] > '9') && (i != 0 || str[i] != '-')) {
-            return false;
-        }
-    }
-    if (str.length() == 1 && str[0] == '-') {
-        return false;
+template <class Limb, Limb Base>
+void BasicBigInt<Limb, Base>::reload_from_string(std::string_view in) {
+    // an empty string reads as zero; the number is parsed aside, so that a string rejected after a
+    // valid prefix leaves *this as it was
+    const char *last = in.data() + in.size();
+    BasicBigInt parsed;
+    if (!in.empty() && parsed.from_chars(in.data(), last).ptr != last) {
+        throw std::invalid_argument("incorrect input");
     }
-    return true;
+    *this = std::move(parsed);
 }
 
-void BigInt::change_base(unsigned long long int new_base) {
-    if (new_base == 0) {
-        throw std::invalid_argument("base cannot be zero");
+template <class Limb, Limb Base>
+std::from_chars_result BasicBigInt<Limb, Base>::from_chars(const char *first, const char *last) {
+    const char *p = first;
+    bool negative = p != last && *p == '-';
+    p += negative;
+    const char *end = skip_digits(p, last);
+    if (end == p) {
+        return {first, std::errc::invalid_argument};
     }
-    auto len_base = (unsigned long long) log10l(new_base);
-
-    if (log10l(new_base) - len_base > 1e-15) {
-        throw std::invalid_argument("incorrect new base: should be pow of 10");
+    while (end - p > 1 && *p == '0') {
+        ++p;
+    }
+    auto len = static_cast<size_t>(end - p);
+    if constexpr (Base == 0) {
+        data = parse_binary(p, len);
+    } else {
+        data.resize((len + base_digits - 1) / base_digits);
+        for (size_t i = 0; i < data.size(); ++i) {
+            size_t to = len - i * base_digits;
+            size_t from = to > static_cast<size_t>(base_digits) ? to - base_digits : 0;
+            data[i] = parse_digits(p + from, to - from);
+        }
     }
-    std::string tmp = to_string();
-    base = new_base;
-    reload_from_string(tmp);
+    is_negative = negative;
     remove_leading_zeros();
+    return {end, std::errc{}};
 }
 
-void BigInt::reload_from_string(const std::string &in) {
-
-    if (!is_correct_string(in)) {
-        throw std::invalid_argument("incorrect input");
-    }
-    data.clear();
-    is_negative = false;
-    std::string tmp_input;
-    if (in[0] == '-') {
-        is_negative = true;
-        tmp_input = in.substr(1);
-    } else {
-        tmp_input = in;
+template <class Limb, Limb Base>
+std::strong_ordering BasicBigInt<Limb, Base>::compare(const BasicBigInt &num) const {
+    if (is_negative != num.is_negative) {
+        return is_negative ? std::strong_ordering::less : std::strong_ordering::greater;
     }
-
-    auto len_base = (int) log10l(base);
-    int i;
-    std::string tmp;
-    for (i = tmp_input.size(); i - len_base >= 0; i = i - len_base) {
-        tmp = tmp_input.substr(i - len_base, len_base);
-
-        data.push_back(std::strtoull(tmp.data(), nullptr, 10));
+    int cmp = compare_limbs(data, num.data);
+    if (is_negative) {
+        cmp = -cmp;
     }
-    if (i > 0) {
-        tmp = tmp_input.substr(0, i);
-        data.push_back(std::strtoull(tmp.data(), nullptr, 10));
+    if (cmp < 0) {
+        return std::strong_ordering::less;
     }
+    return cmp > 0 ? std::strong_ordering::greater : std::strong_ordering::equal;
+}
 
-    remove_leading_zeros();
+template <class Limb, Limb Base>
+BasicBigInt<Limb, Base> BasicBigInt<Limb, Base>::operator+(const BasicBigInt &num) const & {
+    BasicBigInt tmp{*this};
+    tmp += num;
+    return tmp;
 }
 
-std::strong_ordering operator<=>(const BigInt &lhs, const BigInt &rhs) {
-    if (lhs.is_negative && !rhs.is_negative) {
-        return std::strong_ordering::less;
-    } else if (!lhs.is_negative && rhs.is_negative) {
-        return std::strong_ordering::greater;
-    }
-    std::string s1 = lhs.to_string();
-    std::string s2 = rhs.to_string();
-    if (s1.size() > s2.size()) {
-        return std::strong_ordering::greater;
-    } else if (s1.size() < s2.size()) {
-        return std::strong_ordering::less;
-    }
-    for (size_t i = 0; i < s1.size(); ++i) {
-        if (s1[i] > s2[i]) {
-            return std::strong_ordering::greater;
-        } else if (s1[i] < s2[i]) {
-            return std::strong_ordering::less;
-        }
-    }
-    return std::strong_ordering::equal;
+template <class Limb, Limb Base>
+BasicBigInt<Limb, Base> BasicBigInt<Limb, Base>::operator+(const BasicBigInt &num) && {
+    *this += num;
+    return std::move(*this);
 }
 
-bool operator==(const BigInt &lhs, const BigInt &rhs) {
-    return (lhs <=> rhs) == std::strong_ordering::equal;
+template <class Limb, Limb Base>
+BasicBigInt<Limb, Base> BasicBigInt<Limb, Base>::operator-() {
+    BasicBigInt r{*this};
+    r.is_negative = !is_negative && !is_null();
+    return r;
 }
 
-BigInt BigInt::operator+(const BigInt &num) const {
-    BigInt tmp{*this};
-    return tmp += num;
+template <class Limb, Limb Base>
+BasicBigInt<Limb, Base> BasicBigInt<Limb, Base>::operator-(const BasicBigInt &num) const & {
+    BasicBigInt tmp{*this};
+    tmp -= num;
+    return tmp;
 }
 
-BigInt BigInt::operator-() {
-    BigInt r{*this};
-    r.is_negative = !is_negative;
-    return r;
+template <class Limb, Limb Base>
+BasicBigInt<Limb, Base> BasicBigInt<Limb, Base>::operator-(const BasicBigInt &num) && {
+    *this -= num;
+    return std::move(*this);
 }
 
-BigInt BigInt::operator-(const BigInt &num) const {
-    BigInt tmp{*this};
-    return tmp -= num;
+template <class Limb, Limb Base>
+BasicBigInt<Limb, Base> BasicBigInt<Limb, Base>::operator*(const BasicBigInt &num) const & {
+    BasicBigInt tmp{*this};
+    tmp *= num;
+    return tmp;
+}
+
+template <class Limb, Limb Base>
+BasicBigInt<Limb, Base> BasicBigInt<Limb, Base>::operator*(const BasicBigInt &num) && {
+    *this *= num;
+    return std::move(*this);
 }
 
-BigInt BigInt::operator*(const BigInt &num) const {
-    BigInt tmp{*this};
-    return tmp *= num;
+template <class Limb, Limb Base>
+BasicBigInt<Limb, Base> BasicBigInt<Limb, Base>::operator/(const BasicBigInt &num) const & {
+    BasicBigInt tmp{*this};
+    tmp /= num;
+    return tmp;
 }
 
-BigInt BigInt::operator/(const BigInt &num) const {
-    BigInt tmp{*this};
-    return tmp /= num;
+template <class Limb, Limb Base>
+BasicBigInt<Limb, Base> BasicBigInt<Limb, Base>::operator/(const BasicBigInt &num) && {
+    *this /= num;
+    return std::move(*this);
 }
 
-bool BigInt::is_null() const {
+template <class Limb, Limb Base>
+bool BasicBigInt<Limb, Base>::is_null() const {
     return (data.size() == 1 && data[0] == 0) || data.size() == 0;
 }
 
+template <class Limb, Limb Base>
+void BasicBigInt<Limb, Base>::assign_limbs(const Limb *first, size_t n, bool negative) {
+    data.assign(first, first + n);
+    is_negative = negative;
+    remove_leading_zeros();
+}
 
-BigInt::BigInt() : base(1000000000), data({0}), is_negative(false) {}
 
-BigInt &BigInt::operator+=(const BigInt &num) {
-    BigInt tmp{num};
-    tmp.change_base(base);
+template <class Limb, Limb Base>
+BasicBigInt<Limb, Base>::BasicBigInt() : data({0}), is_negative(false) {}
 
-    BigInt tmp2{*this};
-    if (is_negative) {
-        if (tmp.is_negative) {
-            *this = -((-tmp2) + (-tmp));
-            return *this;
-        }
-        *this = tmp - (-tmp2);
-        return *this;
-    } else if (tmp.is_negative) {
-        *this = tmp2 - (-tmp);
-        return *this;
-    }
-    BigInt res;
-    res.change_base(base);
-    res.data.pop_back();
-
-    unsigned long long carry = 0;
-    size_t i = 0;
-    for (; i < std::max(tmp.data.size(), data.size()); ++i) {
-        if (i < tmp.data.size() && i < data.size()) {
-            res.data.push_back((tmp.data[i] + data[i] + carry) % base);
-            carry = (tmp.data[i] + data[i] + carry) / base;
-        } else if (i < data.size()) {
-            res.data.push_back((data[i] + carry) % base);
-            carry = (data[i] + carry) / base;
-        } else {
-            res.data.push_back((tmp.data[i] + carry) % base);
-            carry = (tmp.data[i] + carry) / base;
-        }
-    }
-    while (carry > 0) {
-        res.data.push_back(carry % base);
-        carry /= base;
-    }
+template <class Limb, Limb Base>
+BasicBigInt<Limb, Base> &BasicBigInt<Limb, Base>::operator+=(const BasicBigInt &num) {
+    accumulate(num, false);
+    return *this;
+}
 
-    res.remove_leading_zeros();
-    *this = res;
+template <class Limb, Limb Base>
+BasicBigInt<Limb, Base> &BasicBigInt<Limb, Base>::operator-=(const BasicBigInt &num) {
+    accumulate(num, true);
     return *this;
 }
 
-BigInt &BigInt::operator-=(const BigInt &num) {
-    if (this == &num) {
-        *this = BigInt(0);
-        return *this;
-    }
-    BigInt t{num};
-    if (base != num.base) {
-        BigInt tmp = num;
-        tmp.change_base(base);
-        return *this -= tmp;
+template <class Limb, Limb Base>
+void BasicBigInt<Limb, Base>::accumulate(const BasicBigInt &num, bool subtract) {
+    bool num_negative = num.is_negative != subtract;
+    if (is_negative == num_negative) {
+        add_magnitude(data, num.data, Radix<Base>{});
+    } else if (compare_limbs(data, num.data) >= 0) {
+        sub_magnitude(data, num.data, Radix<Base>{});
+    } else {
+        sub_magnitude_from(data, num.data, Radix<Base>{});
+        is_negative = num_negative;
     }
+    remove_leading_zeros();
+}
 
-    if (num.is_negative) {
-        return *this += (-t);
-    }
-    if (is_negative) {
-        *this = -((-*this) + num);
-        return *this;
-    }
-    if (*this < num) {
-        BigInt res = num - *this;
-        res.is_negative = true;
-        *this = res;
-        return *this;
+template <class Limb, Limb Base>
+void BasicBigInt<Limb, Base>::accumulate_word(Limb magnitude, bool negative) {
+    if (magnitude == 0) {
+        return;
     }
-    long long carry = 0;
-    for (size_t i = 0; i < num.data.size() || carry; ++i) {
-        const long long num_digit = (i < num.data.size()) ? num.data[i] : 0;
-
-
-        long long diff = data[i] - num_digit - carry;
-        carry = 0;
-
-        if (diff < 0) {
-            diff += base;
-            carry = 1;
+    WordLimbs<Radix<Base>> num(magnitude);
+    if (is_negative == negative) {
+        // the carry usually stops at the first limb
+        if (data.size() < num.size) {
+            data.resize(num.size, 0);
         }
-
-        data[i] = diff;
+        if (add_limbs(data.data(), data.size(), num.limbs.data(), num.size, Radix<Base>{})) {
+            data.push_back(1);
+        }
+    } else if (!word_exceeds(num, data)) {
+        sub_limbs(data.data(), data.size(), num.limbs.data(), num.size, Radix<Base>{});
+    } else {
+        sub_limbs(num.limbs.data(), num.size, data.data(), data.size(), Radix<Base>{});
+        data.assign(num.limbs.begin(), num.limbs.begin() + num.size);
+        is_negative = negative;
     }
+    remove_leading_zeros();
+}
 
+template <class Limb, Limb Base>
+void BasicBigInt<Limb, Base>::multiply_word(Limb magnitude, bool negative) {
+    multiply_limb(data, magnitude, Radix<Base>{});
+    is_negative = is_negative != negative;
+    remove_leading_zeros();
+}
 
+template <class Limb, Limb Base>
+void BasicBigInt<Limb, Base>::divide_word(Limb magnitude, bool negative) {
+    if (magnitude == 0) {
+        throw std::invalid_argument("denominator should be not 0");
+    }
+    divide_limb(data, magnitude, Radix<Base>{});
+    is_negative = is_negative != negative;
     remove_leading_zeros();
-    return *this;
 }
 
-BigInt &BigInt::operator*=(const BigInt &num) {
-    BigInt tmp{*this};
-    BigInt tmp2{num};
-    tmp2.change_base(base);
-    BigInt res;
-    res.change_base(base);
-    res.data.resize(tmp.data.size() + tmp2.data.size());
-    if (is_negative) {
-        if (num.is_negative) {
-            *this = (-tmp) * (-tmp2);
-            remove_leading_zeros();
-            return *this;
-        }
-        *this = -((-tmp) * tmp2);
-        remove_leading_zeros();
-        return *this;
-    }
-    if (num.is_negative) {
-        *this = -((-tmp2) * tmp);
-        remove_leading_zeros();
-        return *this;
-    }
-    unsigned long long carry = 0;
-
-    for (size_t i = 0; i < tmp.data.size(); ++i) {
-        for (size_t j = 0; j < tmp2.data.size() || carry; ++j) {
-            unsigned long long cur;
-            if (j < tmp2.data.size()) {
-                cur = res.data[i + j] + tmp.data[i] * tmp2.data[j] + carry;
-            } else {
-                cur = res.data[i + j] + carry;
-            }
-            res.data[i + j] = cur % base;
-            carry = cur / base;
-        }
+template <class Limb, Limb Base>
+void BasicBigInt<Limb, Base>::remainder_word(Limb magnitude, bool negative) {
+    if (magnitude == 0) {
+        throw std::invalid_argument("denominator should be not 0");
     }
+    WordLimbs<Radix<Base>> rem(divide_limb(data, magnitude, Radix<Base>{}));
+    data.assign(rem.limbs.begin(), rem.limbs.begin() + rem.size);
+    // the sign rules of operator%=
+    is_negative = is_negative && !negative;
+    remove_leading_zeros();
+}
 
-    res.remove_leading_zeros();
-    *this = res;
+template <class Limb, Limb Base>
+BasicBigInt<Limb, Base> &BasicBigInt<Limb, Base>::operator*=(const BasicBigInt &num) {
+    Limbs res(data.size() + num.data.size());
+    mpn::mul<Base>(res.data(), data.data(), data.size(), num.data.data(), num.data.size());
+    data.swap(res);
+    is_negative = is_negative != num.is_negative;
+    remove_leading_zeros();
     return *this;
 }
 
-BigInt &BigInt::operator/=(const BigInt &num) {
-    BigInt dividend{*this};
-    BigInt divisor{num};
-    if (is_negative) {
-        if (num.is_negative) {
-            *this = (-dividend) / (-divisor);
-            remove_leading_zeros();
-            return *this;
-        }
-        *this = -((-dividend) / divisor);
-        remove_leading_zeros();
-        return *this;
-    } else if (num.is_negative) {
-        *this = -(dividend / (-divisor));
-        remove_leading_zeros();
-        return *this;
-    }
-    divisor.change_base(dividend.base);
-    std::pair<BigInt, BigInt> res = divide(dividend, divisor);
-    *this = res.first;
-    remove_leading_zeros();
+// a decimal Comba basecase saves a division per partial product and keeps up with Karatsuba for longer
+template <class Limb, Limb Base>
+size_t BasicBigInt<Limb, Base>::karatsuba_threshold = Base == 0 ? 32 : 64;
+template <class Limb, Limb Base>
+size_t BasicBigInt<Limb, Base>::comba_threshold = Base == 0 ? 24 : 10;
+template <class Limb, Limb Base>
+size_t BasicBigInt<Limb, Base>::toom3_threshold = 200;
+// full 2^64 limbs have no divisions in the basecase, so the NTT pays off only for much longer operands
+template <class Limb, Limb Base>
+size_t BasicBigInt<Limb, Base>::ntt_threshold = Base == 0 ? 10000 : 450;
+template <class Limb, Limb Base>
+size_t BasicBigInt<Limb, Base>::parallel_threshold = Base == 0 ? 10000 : 20000;
+
+template <class Limb, Limb Base>
+BasicBigInt<Limb, Base> &BasicBigInt<Limb, Base>::operator/=(const BasicBigInt &num) {
+    *this = divide(*this, num).first;
     return *this;
 }
 
-BigInt &BigInt::operator++() {
-    return *this += BigInt(1);
+template <class Limb, Limb Base>
+BasicBigInt<Limb, Base> &BasicBigInt<Limb, Base>::operator++() {
+    accumulate_word(1, false);
+    return *this;
 }
 
-BigInt &BigInt::operator--() {
-    return *this -= BigInt(1);
+template <class Limb, Limb Base>
+BasicBigInt<Limb, Base> &BasicBigInt<Limb, Base>::operator--() {
+    accumulate_word(1, true);
+    return *this;
 }
 
-BigInt BigInt::operator++(int) {
-    BigInt tmp{*this};
-    *this += BigInt(1);
+template <class Limb, Limb Base>
+BasicBigInt<Limb, Base> BasicBigInt<Limb, Base>::operator++(int) {
+    BasicBigInt tmp{*this};
+    accumulate_word(1, false);
     return tmp;
 }
 
-BigInt BigInt::operator--(int) {
-    BigInt tmp{*this};
-    *this -= BigInt(1);
+template <class Limb, Limb Base>
+BasicBigInt<Limb, Base> BasicBigInt<Limb, Base>::operator--(int) {
+    BasicBigInt tmp{*this};
+    accumulate_word(1, true);
     return tmp;
 }
 
-BigInt &BigInt::operator%=(const BigInt &num) {
-    BigInt tmp = *this / num;
-    *this = *this - tmp * num;
-    if(is_negative && num.is_negative) {
+template <class Limb, Limb Base>
+BasicBigInt<Limb, Base> &BasicBigInt<Limb, Base>::operator%=(const BasicBigInt &num) {
+    bool both_negative = is_negative && num.is_negative;
+    *this = divide(*this, num).second;
+    if (both_negative) {
         is_negative = false;
     }
     return *this;
 }
 
-BigInt BigInt::operator%(const BigInt &num) const {
-    BigInt tmp{*this};
-    return tmp %= num;
+template <class Limb, Limb Base>
+BasicBigInt<Limb, Base> BasicBigInt<Limb, Base>::operator%(const BasicBigInt &num) const & {
+    BasicBigInt tmp{*this};
+    tmp %= num;
+    return tmp;
 }
 
-void BigInt::shift_left(int k) {
-    if(k > 0) {
-        data.insert(data.begin(), k, 0);
-    } else if(k < 0) {
-        for (int i = 0; i < abs(k); ++i) {
-            data.erase(data.begin());
-        }
-    }
+template <class Limb, Limb Base>
+BasicBigInt<Limb, Base> BasicBigInt<Limb, Base>::operator%(const BasicBigInt &num) && {
+    *this %= num;
+    return std::move(*this);
 }
 
-
-std::pair<BigInt, BigInt> BigInt::divide(const BigInt &lhs, const BigInt &rhs) {
+template <class Limb, Limb Base>
+std::pair<BasicBigInt<Limb, Base>, BasicBigInt<Limb, Base>> BasicBigInt<Limb, Base>::divide(const BasicBigInt &lhs,
+                                                                                            const BasicBigInt &rhs) {
     if (rhs.is_null()) {
         throw std::invalid_argument("denominator should be not 0");
     }
-    BigInt remainder;
-    BigInt quotient;
-    quotient.change_base(lhs.base);
-    remainder.change_base(lhs.base);
+    BasicBigInt quotient;
+    BasicBigInt remainder;
+    divide_limbs(lhs.data, rhs.data, quotient.data, remainder.data, Radix<Base>{});
+    quotient.is_negative = lhs.is_negative != rhs.is_negative;
+    remainder.is_negative = lhs.is_negative;
+    quotient.remove_leading_zeros();
+    remainder.remove_leading_zeros();
+    return {quotient, remainder};
+}
 
-    BigInt dividend{lhs};
-    BigInt divisor{rhs};
+template <class Limb, Limb Base>
+size_t BasicBigInt<Limb, Base>::burnikel_ziegler_threshold = 60;
 
-    while (true) {
+template <class Limb, Limb Base>
+BasicBigInt<Limb, Base> BasicBigInt<Limb, Base>::square(const BasicBigInt &num) {
+    BasicBigInt res;
+    res.data.assign(2 * num.data.size(), 0);
+    ::square(num.data.data(), num.data.size(), res.data.data(), Radix<Base>{});
+    res.remove_leading_zeros();
+    return res;
+}
+
+template <class Limb, Limb Base>
+void BasicBigInt<Limb, Base>::add_product(const BasicBigInt &lhs, const BasicBigInt &rhs, bool subtract) {
+    bool negative = (lhs.is_negative != rhs.is_negative) != subtract;
+    const Limbs &a = lhs.data.size() >= rhs.data.size() ? lhs.data : rhs.data;
+    const Limbs &b = lhs.data.size() >= rhs.data.size() ? rhs.data : lhs.data;
+    if ((is_null() || is_negative == negative) && this != &lhs && this != &rhs &&
+        b.size() < std::max<size_t>(karatsuba_threshold, 4)) {
+        // the schoolbook rows add straight into the limbs of *this, which gain room for the carry
+        data.resize(std::max(data.size(), a.size() + b.size()) + 1, 0);
+        mul_basecase(a.data(), a.size(), b.data(), b.size(), data.data(), Radix<Base>{});
+        is_negative = negative;
+    } else {
+        Limbs product(a.size() + b.size());
+        mpn::mul<Base>(product.data(), a.data(), a.size(), b.data(), b.size());
+        trim_limbs(product);
+        if (is_negative == negative) {
+            add_magnitude(data, product, Radix<Base>{});
+        } else if (compare_limbs(data, product) >= 0) {
+            sub_magnitude(data, product, Radix<Base>{});
+        } else {
+            sub_magnitude_from(data, product, Radix<Base>{});
+            is_negative = negative;
+        }
+    }
+    remove_leading_zeros();
+}
+
+template <class Limb, Limb Base>
+BasicBigInt<Limb, Base> BasicBigInt<Limb, Base>::mul_mod(const BasicBigInt &lhs, const BasicBigInt &rhs,
+                                                         const BasicBigInt &mod) {
+    if (mod.is_null()) {
+        throw std::invalid_argument("denominator should be not 0");
+    }
+    // the product buffer becomes the remainder, no quotient number is built
+    BasicBigInt res;
+    res.data.resize(lhs.data.size() + rhs.data.size());
+    mpn::mul<Base>(res.data.data(), lhs.data.data(), lhs.data.size(), rhs.data.data(), rhs.data.size());
+    trim_limbs(res.data);
+    if (compare_limbs(res.data, mod.data) >= 0) {
+        Limbs q;
+        Limbs rem;
+        divide_limbs(res.data, mod.data, q, rem, Radix<Base>{});
+        res.data = std::move(rem);
+    }
+    // the sign rules of operator%
+    res.is_negative = lhs.is_negative != rhs.is_negative && !mod.is_negative;
+    res.remove_leading_zeros();
+    return res;
+}
 
-        if(dividend < rhs) {
-            break;
+template <class Limb, Limb Base>
+BasicBigInt<Limb, Base> BasicBigInt<Limb, Base>::sum(const Term *terms, size_t count) {
+    size_t len = 0;
+    for (size_t k = 0; k < count; ++k) {
+        len = std::max(len, terms[k].num->data.size());
+    }
+    // every column takes all the terms at once; the signed carry is at most count in magnitude
+    using Signed = std::conditional_t<Base == 0, int128, long long>;
+    BasicBigInt res;
+    res.data.assign(len, 0);
+    Signed carry = 0;
+    for (size_t i = 0; i < len; ++i) {
+        Signed acc = carry;
+        for (size_t k = 0; k < count; ++k) {
+            const BasicBigInt &num = *terms[k].num;
+            if (i < num.data.size()) {
+                auto limb = static_cast<Signed>(num.data[i]);
+                acc += num.is_negative != terms[k].negate ? -limb : limb;
+            }
         }
-        divisor.shift_left(dividend.data.size() - divisor.data.size());
-        while (dividend < divisor) {
-            quotient.data.push_back(0);
-            divisor.shift_left(-1);
+        if constexpr (Base == 0) {
+            res.data[i] = static_cast<Limb>(acc);
+            carry = acc >> 64;
+        } else {
+            // floor division, so that the limb stays in [0, B)
+            carry = acc / static_cast<Signed>(Base);
+            acc %= static_cast<Signed>(Base);
+            if (acc < 0) {
+                acc += static_cast<Signed>(Base);
+                --carry;
+            }
+            res.data[i] = static_cast<Limb>(acc);
         }
-        BigInt tmp{divisor};
-        size_t k = 1;
-        while (divisor + tmp <= dividend) {
-            divisor += tmp;
-            ++k;
+    }
+    if (carry < 0) {
+        // the limbs hold carry * B^len + low, its magnitude is (-carry - 1) * B^len + (B^len - low)
+        carry = -carry;
+        size_t i = 0;
+        while (i < len && res.data[i] == 0) {
+            ++i;
+        }
+        if (i < len) {
+            res.data[i] = static_cast<Limb>(Radix<Base>::radix() - res.data[i]);
+            for (++i; i < len; ++i) {
+                res.data[i] = static_cast<Limb>(Radix<Base>::radix() - 1 - res.data[i]);
+            }
+            --carry;
         }
-        dividend -= divisor;
-        quotient.data.push_back(k);
-        divisor = rhs;
+        res.is_negative = true;
     }
-    std::reverse(quotient.data.begin(), quotient.data.end());
-    quotient.normalize();
-    remainder = dividend;
-    return {quotient, remainder};
+    for (; carry > 0; carry /= static_cast<Signed>(Radix<Base>::radix())) {
+        res.data.push_back(static_cast<Limb>(carry % static_cast<Signed>(Radix<Base>::radix())));
+    }
+    res.remove_leading_zeros();
+    return res;
 }
 
-void BigInt::normalize() {
-    unsigned long long carry = 0;
-    for (size_t i = 0; i < data.size() || carry; ++i) {
-        if(i == data.size()) {
-            data.push_back(0);
-        }
-        data[i] += carry;
-        carry = data[i] / base;
-        data[i] %= base;
+template <class Limb, Limb Base>
+BasicBigInt<Limb, Base> BasicBigInt<Limb, Base>::pow(const BasicBigInt &base, uint64_t exp) {
+    if (exp == 0) {
+        return BasicBigInt{1};
     }
-    remove_leading_zeros();
+    return window_pow(base, {exp}, [](BasicBigInt &x) {
+        x = square(x);
+    }, [](BasicBigInt &x, const BasicBigInt &y) {
+        x *= y;
+    });
 }
+
+template class BasicBigInt<unsigned long long, 10>;
+template class BasicBigInt<unsigned long long, 1000>;
+template class BasicBigInt<unsigned long long, 1000000000>;
+template class BasicBigInt<unsigned long long, 0>;
+
+// conversions between them
+template BasicBigInt<unsigned long long, 10>::BasicBigInt(const BasicBigInt<unsigned long long, 1000> &);
+template BasicBigInt<unsigned long long, 10>::BasicBigInt(const BasicBigInt<unsigned long long, 1000000000> &);
+template BasicBigInt<unsigned long long, 10>::BasicBigInt(const BasicBigInt<unsigned long long, 0> &);
+template BasicBigInt<unsigned long long, 1000>::BasicBigInt(const BasicBigInt<unsigned long long, 10> &);
+template BasicBigInt<unsigned long long, 1000>::BasicBigInt(const BasicBigInt<unsigned long long, 1000000000> &);
+template BasicBigInt<unsigned long long, 1000>::BasicBigInt(const BasicBigInt<unsigned long long, 0> &);
+template BasicBigInt<unsigned long long, 1000000000>::BasicBigInt(const BasicBigInt<unsigned long long, 10> &);
+template BasicBigInt<unsigned long long, 1000000000>::BasicBigInt(const BasicBigInt<unsigned long long, 1000> &);
+template BasicBigInt<unsigned long long, 1000000000>::BasicBigInt(const BasicBigInt<unsigned long long, 0> &);
+template BasicBigInt<unsigned long long, 0>::BasicBigInt(const BasicBigInt<unsigned long long, 10> &);
+template BasicBigInt<unsigned long long, 0>::BasicBigInt(const BasicBigInt<unsigned long long, 1000> &);
+template BasicBigInt<unsigned long long, 0>::BasicBigInt(const BasicBigInt<unsigned long long, 1000000000> &);
+
+// the limb layer of each of them
+template mpn::limb_t mpn::add_n<10>(mpn::limb_t *, const mpn::limb_t *, const mpn::limb_t *, size_t);
+template mpn::limb_t mpn::sub_n<10>(mpn::limb_t *, const mpn::limb_t *, const mpn::limb_t *, size_t);
+template mpn::limb_t mpn::mul_1<10>(mpn::limb_t *, const mpn::limb_t *, size_t, mpn::limb_t);
+template mpn::limb_t mpn::addmul_1<10>(mpn::limb_t *, const mpn::limb_t *, size_t, mpn::limb_t);
+template void mpn::mul<10>(mpn::limb_t *, const mpn::limb_t *, size_t, const mpn::limb_t *, size_t);
+template mpn::limb_t mpn::divrem_1<10>(mpn::limb_t *, const mpn::limb_t *, size_t, mpn::limb_t);
+template void mpn::divrem<10>(mpn::limb_t *, mpn::limb_t *, const mpn::limb_t *, size_t, const mpn::limb_t *,
+                               size_t, mpn::limb_t *);
+template mpn::limb_t mpn::add_n<1000>(mpn::limb_t *, const mpn::limb_t *, const mpn::limb_t *, size_t);
+template mpn::limb_t mpn::sub_n<1000>(mpn::limb_t *, const mpn::limb_t *, const mpn::limb_t *, size_t);
+template mpn::limb_t mpn::mul_1<1000>(mpn::limb_t *, const mpn::limb_t *, size_t, mpn::limb_t);
+template mpn::limb_t mpn::addmul_1<1000>(mpn::limb_t *, const mpn::limb_t *, size_t, mpn::limb_t);
+template void mpn::mul<1000>(mpn::limb_t *, const mpn::limb_t *, size_t, const mpn::limb_t *, size_t);
+template mpn::limb_t mpn::divrem_1<1000>(mpn::limb_t *, const mpn::limb_t *, size_t, mpn::limb_t);
+template void mpn::divrem<1000>(mpn::limb_t *, mpn::limb_t *, const mpn::limb_t *, size_t, const mpn::limb_t *,
+                               size_t, mpn::limb_t *);
+template mpn::limb_t mpn::add_n<1000000000>(mpn::limb_t *, const mpn::limb_t *, const mpn::limb_t *, size_t);
+template mpn::limb_t mpn::sub_n<1000000000>(mpn::limb_t *, const mpn::limb_t *, const mpn::limb_t *, size_t);
+template mpn::limb_t mpn::mul_1<1000000000>(mpn::limb_t *, const mpn::limb_t *, size_t, mpn::limb_t);
+template mpn::limb_t mpn::addmul_1<1000000000>(mpn::limb_t *, const mpn::limb_t *, size_t, mpn::limb_t);
+template void mpn::mul<1000000000>(mpn::limb_t *, const mpn::limb_t *, size_t, const mpn::limb_t *, size_t);
+template mpn::limb_t mpn::divrem_1<1000000000>(mpn::limb_t *, const mpn::limb_t *, size_t, mpn::limb_t);
+template void mpn::divrem<1000000000>(mpn::limb_t *, mpn::limb_t *, const mpn::limb_t *, size_t, const mpn::limb_t *,
+                               size_t, mpn::limb_t *);
+template mpn::limb_t mpn::add_n<0>(mpn::limb_t *, const mpn::limb_t *, const mpn::limb_t *, size_t);
+template mpn::limb_t mpn::sub_n<0>(mpn::limb_t *, const mpn::limb_t *, const mpn::limb_t *, size_t);
+template mpn::limb_t mpn::mul_1<0>(mpn::limb_t *, const mpn::limb_t *, size_t, mpn::limb_t);
+template mpn::limb_t mpn::addmul_1<0>(mpn::limb_t *, const mpn::limb_t *, size_t, mpn::limb_t);
+template void mpn::mul<0>(mpn::limb_t *, const mpn::limb_t *, size_t, const mpn::limb_t *, size_t);
+template mpn::limb_t mpn::divrem_1<0>(mpn::limb_t *, const mpn::limb_t *, size_t, mpn::limb_t);
+template void mpn::divrem<0>(mpn::limb_t *, mpn::limb_t *, const mpn::limb_t *, size_t, const mpn::limb_t *,
+                               size_t, mpn::limb_t *);
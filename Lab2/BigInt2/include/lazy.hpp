@@ -0,0 +1,115 @@
+#pragma once
+
+#include "bigint.hpp"
+
+// deferred BasicBigInt expressions, opted into with lazy(x). The patterns below run as one fused
+// kernel writing a single result instead of materialising every intermediate:
+//   acc += lazy(a) * b, acc -= lazy(a) * b    multiply-accumulate into the limbs of acc
+//   lazy(a) * b + c, c - lazy(a) * b          the same into a copy of c
+//   lazy(a) * b % m                           multiply-mod, the product buffer reduced in place
+//   lazy(a) + b - c + ... + z                 a sum of many terms, column by column
+// and any other use converts the expression to a BasicBigInt. The nodes refer to their operands,
+// so an expression is meant to be consumed by the statement that builds it
+namespace bigint_lazy {
+    template <class Number>
+    struct Ref {
+        const Number &num;
+    };
+
+    template <class Number>
+    struct Product {
+        const Number &lhs;
+        const Number &rhs;
+
+        operator Number() const {
+            return lhs * rhs;
+        }
+    };
+
+    template <class Number>
+    struct Sum {
+        SmallVector<typename Number::Term, 8> terms;
+
+        operator Number() const {
+            return Number::sum(terms.data(), terms.size());
+        }
+    };
+
+    template <class Number>
+    Product<Number> operator*(Ref<Number> lhs, const Number &rhs) {
+        return {lhs.num, rhs};
+    }
+
+    template <class Number>
+    Product<Number> operator*(Ref<Number> lhs, Ref<Number> rhs) {
+        return {lhs.num, rhs.num};
+    }
+
+    template <class Number>
+    Number operator%(const Product<Number> &product, const Number &mod) {
+        return Number::mul_mod(product.lhs, product.rhs, mod);
+    }
+
+    template <class Number>
+    Number &operator+=(Number &acc, const Product<Number> &product) {
+        acc.add_product(product.lhs, product.rhs);
+        return acc;
+    }
+
+    template <class Number>
+    Number &operator-=(Number &acc, const Product<Number> &product) {
+        acc.add_product(product.lhs, product.rhs, true);
+        return acc;
+    }
+
+    template <class Number>
+    Number operator+(const Product<Number> &product, Number num) {
+        num += product;
+        return num;
+    }
+
+    template <class Number>
+    Number operator+(Number num, const Product<Number> &product) {
+        num += product;
+        return num;
+    }
+
+    template <class Number>
+    Number operator-(Number num, const Product<Number> &product) {
+        num -= product;
+        return num;
+    }
+
+    template <class Number>
+    Sum<Number> operator+(Ref<Number> lhs, const Number &rhs) {
+        Sum<Number> res;
+        res.terms.push_back({&lhs.num, false});
+        res.terms.push_back({&rhs, false});
+        return res;
+    }
+
+    template <class Number>
+    Sum<Number> operator-(Ref<Number> lhs, const Number &rhs) {
+        Sum<Number> res;
+        res.terms.push_back({&lhs.num, false});
+        res.terms.push_back({&rhs, true});
+        return res;
+    }
+
+    template <class Number>
+    Sum<Number> operator+(Sum<Number> &&sum, const Number &rhs) {
+        sum.terms.push_back({&rhs, false});
+        return std::move(sum);
+    }
+
+    template <class Number>
+    Sum<Number> operator-(Sum<Number> &&sum, const Number &rhs) {
+        sum.terms.push_back({&rhs, true});
+        return std::move(sum);
+    }
+}
+
+template <class Limb, Limb Base>
+bigint_lazy::Ref<BasicBigInt<Limb, Base>> lazy(const BasicBigInt<Limb, Base> &num) {
+    return {num};
+}
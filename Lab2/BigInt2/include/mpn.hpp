@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+
+// the limb layer under BasicBigInt<unsigned long long, Base>, in the manner of GMP's mpn functions:
+// a magnitude is a span of limbs of the radix, lowest first, every result goes into a buffer of the
+// caller and carries and remainders come back as the return value. Results may share a buffer with
+// an operand only where noted. Nothing here allocates, except mul and divrem past the Karatsuba and
+// Burnikel-Ziegler thresholds of BasicBigInt, whose tiers take scratch memory of their own.
+// Defined for the radices of the library: 10, 1000, 10^9 and 0 for 2^64.
+namespace mpn {
+    using limb_t = unsigned long long;
+
+    // the code paths behind the kernels below, bound when the library loads to the best one the CPU
+    // supports. add_n and sub_n run portable, AVX2 or AVX-512 code; mul_1 and addmul_1 on binary
+    // limbs run portable code, mulx (BMI2) or mulx with the two carry chains of adcx and adox (ADX)
+    enum class kernel { portable, avx2, avx512, bmi2, adx };
+
+    // whether this build and CPU can run k
+    bool supports(kernel k);
+
+    const char *kernel_name(kernel k);
+
+    // the code add_n and sub_n currently run
+    kernel add_kernel();
+
+    // rebinds add_n and sub_n to k, e.g. to compare kernels; throws std::invalid_argument when
+    // supports(k) is false. Not to be called while other threads use the library
+    void use_add_kernel(kernel k);
+
+    // the code mul_1 and addmul_1 currently run on binary limbs
+    kernel mul_kernel();
+
+    // rebinds mul_1 and addmul_1 to k, on the terms of use_add_kernel
+    void use_mul_kernel(kernel k);
+
+    // rp[0 .. n) = up + vp, returning the carry, 0 or 1; rp may be up or vp
+    template <limb_t Base>
+    limb_t add_n(limb_t *rp, const limb_t *up, const limb_t *vp, size_t n);
+
+    // rp[0 .. n) = up - vp mod B^n, returning the borrow, 0 or 1; rp may be up or vp
+    template <limb_t Base>
+    limb_t sub_n(limb_t *rp, const limb_t *up, const limb_t *vp, size_t n);
+
+    // rp[0 .. n) = up * v mod B^n for v below the radix, returning the limb carried out; rp may be up
+    template <limb_t Base>
+    limb_t mul_1(limb_t *rp, const limb_t *up, size_t n, limb_t v);
+
+    // rp[0 .. n) += up * v mod B^n for v below the radix, returning the limb carried out
+    template <limb_t Base>
+    limb_t addmul_1(limb_t *rp, const limb_t *up, size_t n, limb_t v);
+
+    // rp[0 .. un + vn) = up * vp for un, vn >= 1; rp overlaps neither operand
+    template <limb_t Base>
+    void mul(limb_t *rp, const limb_t *up, size_t un, const limb_t *vp, size_t vn);
+
+    // qp[0 .. n) = up / d for any d > 0, returning up % d; qp may be up
+    template <limb_t Base>
+    limb_t divrem_1(limb_t *qp, const limb_t *up, size_t n, limb_t d);
+
+    // limbs of scratch space divrem needs
+    constexpr size_t divrem_itch(size_t un, size_t dn) {
+        return un + dn + 1;
+    }
+
+    // qp[0 .. un - dn + 1) = up / dp and rp[0 .. dn) = up % dp for un >= dn >= 1 and a nonzero top
+    // limb dp[dn - 1]; scratch holds divrem_itch(un, dn) limbs, and no buffer overlaps another
+    template <limb_t Base>
+    void divrem(limb_t *qp, limb_t *rp, const limb_t *up, size_t un, const limb_t *dp, size_t dn,
+                limb_t *scratch);
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+
+namespace ntt {
+    // longest cyclic convolution all three primes can carry out
+    constexpr size_t max_length = size_t(1) << 23;
+
+    // whether a product of limbs below base with the given lengths can be computed exactly;
+    // base 0 stands for full 2^64 limbs
+    bool fits(size_t n, size_t m, unsigned long long base);
+
+    // res[0 .. n + m) = a * b in the given base, every limb of it written. In parallel the three
+    // convolutions and the passes of each transform are shared out over parallel::for_each
+    void multiply(const unsigned long long *a, size_t n, const unsigned long long *b, size_t m,
+                  unsigned long long *res, unsigned long long base, bool parallel = false);
+}
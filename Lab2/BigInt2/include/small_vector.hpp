@@ -0,0 +1,256 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// a vector of trivially copyable values that keeps up to N of them inside the object and moves to
+// the heap only when it grows past that; the elements are always contiguous at data()
+template <class T, size_t N>
+class SmallVector {
+    static_assert(std::is_trivially_copyable_v<T>, "elements are moved with memcpy");
+    static_assert(N > 0, "at least one element is stored inline");
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    SmallVector() = default;
+
+    explicit SmallVector(size_t n, const T &value = T{}) {
+        assign(n, value);
+    }
+
+    template <class It, class = typename std::iterator_traits<It>::iterator_category>
+    SmallVector(It first, It last) {
+        assign(first, last);
+    }
+
+    SmallVector(std::initializer_list<T> init) {
+        assign(init.begin(), init.end());
+    }
+
+    SmallVector(const SmallVector &other) {
+        assign(other.begin(), other.end());
+    }
+
+    // a heap buffer changes hands, inline elements are copied
+    SmallVector(SmallVector &&other) noexcept {
+        steal(other);
+    }
+
+    ~SmallVector() {
+        release();
+    }
+
+    SmallVector &operator=(const SmallVector &other) {
+        if (this != &other) {
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    SmallVector &operator=(SmallVector &&other) noexcept {
+        if (this != &other) {
+            release();
+            steal(other);
+        }
+        return *this;
+    }
+
+    SmallVector &operator=(std::initializer_list<T> init) {
+        assign(init.begin(), init.end());
+        return *this;
+    }
+
+    T *data() noexcept {
+        return ptr;
+    }
+
+    const T *data() const noexcept {
+        return ptr;
+    }
+
+    size_t size() const noexcept {
+        return count;
+    }
+
+    size_t capacity() const noexcept {
+        return cap;
+    }
+
+    bool empty() const noexcept {
+        return count == 0;
+    }
+
+    // whether the elements live inside the object
+    bool is_inline() const noexcept {
+        return ptr == buffer;
+    }
+
+    T *begin() noexcept {
+        return ptr;
+    }
+
+    T *end() noexcept {
+        return ptr + count;
+    }
+
+    const T *begin() const noexcept {
+        return ptr;
+    }
+
+    const T *end() const noexcept {
+        return ptr + count;
+    }
+
+    T &operator[](size_t i) noexcept {
+        return ptr[i];
+    }
+
+    const T &operator[](size_t i) const noexcept {
+        return ptr[i];
+    }
+
+    T &back() noexcept {
+        return ptr[count - 1];
+    }
+
+    const T &back() const noexcept {
+        return ptr[count - 1];
+    }
+
+    void reserve(size_t n) {
+        if (n > cap) {
+            reallocate(n);
+        }
+    }
+
+    void clear() noexcept {
+        count = 0;
+    }
+
+    void push_back(const T &value) {
+        if (count == cap) {
+            T copy = value;
+            // cap >= N, spelled out so that the compiler sees a nonempty buffer
+            reallocate(std::max(2 * cap, 2 * N));
+            ptr[count++] = copy;
+        } else {
+            ptr[count++] = value;
+        }
+    }
+
+    void pop_back() noexcept {
+        --count;
+    }
+
+    // new elements are value-initialised, as in std::vector
+    void resize(size_t n, const T &value = T{}) {
+        // value may be an element of this vector, so it is read before a reallocation frees it
+        T fill = value;
+        if (n > cap) {
+            reallocate(std::max(n, 2 * cap));
+        }
+        if (n > count) {
+            std::fill(ptr + count, ptr + n, fill);
+        }
+        count = n;
+    }
+
+    void assign(size_t n, const T &value) {
+        count = 0;
+        resize(n, value);
+    }
+
+    template <class It, class = typename std::iterator_traits<It>::iterator_category>
+    void assign(It first, It last) {
+        auto n = static_cast<size_t>(std::distance(first, last));
+        if (n > cap) {
+            // the source may be inside the current buffer
+            SmallVector fresh;
+            fresh.reallocate(n);
+            std::copy(first, last, fresh.ptr);
+            fresh.count = n;
+            *this = std::move(fresh);
+            return;
+        }
+        std::copy(first, last, ptr);
+        count = n;
+    }
+
+    template <class It, class = typename std::iterator_traits<It>::iterator_category>
+    void append(It first, It last) {
+        auto n = static_cast<size_t>(std::distance(first, last));
+        if (count + n > cap) {
+            // the source may be inside the current buffer
+            SmallVector grown;
+            grown.reallocate(std::max(count + n, 2 * cap));
+            std::memcpy(grown.ptr, ptr, count * sizeof(T));
+            std::copy(first, last, grown.ptr + count);
+            grown.count = count + n;
+            *this = std::move(grown);
+        } else {
+            std::copy(first, last, ptr + count);
+            count += n;
+        }
+    }
+
+    // drops the first n elements, n <= size()
+    void erase_prefix(size_t n) noexcept {
+        std::memmove(ptr, ptr + n, (count - n) * sizeof(T));
+        count -= n;
+    }
+
+    void swap(SmallVector &other) noexcept {
+        SmallVector tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    friend bool operator==(const SmallVector &lhs, const SmallVector &rhs) {
+        return lhs.count == rhs.count && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+private:
+    T *ptr = buffer;
+    size_t count = 0;
+    size_t cap = N;
+    T buffer[N];
+
+    void reallocate(size_t n) {
+        T *fresh = static_cast<T *>(::operator new(n * sizeof(T)));
+        std::memcpy(fresh, ptr, count * sizeof(T));
+        release();
+        ptr = fresh;
+        cap = n;
+    }
+
+    void release() noexcept {
+        if (ptr != buffer) {
+            ::operator delete(ptr);
+        }
+    }
+
+    void steal(SmallVector &other) noexcept {
+        if (other.ptr == other.buffer) {
+            ptr = buffer;
+            cap = N;
+            std::memcpy(buffer, other.buffer, other.count * sizeof(T));
+        } else {
+            ptr = other.ptr;
+            cap = other.cap;
+            other.ptr = other.buffer;
+            other.cap = N;
+        }
+        count = other.count;
+        other.count = 0;
+    }
+};
@@ -0,0 +1,255 @@
+#include "../include/ntt.hpp"
+#include "../include/parallel.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace {
+    __extension__ typedef unsigned __int128 uint128;
+
+    template <unsigned P>
+    unsigned pow_mod(unsigned long long a, unsigned long long e) {
+        unsigned long long r = 1;
+        a %= P;
+        while (e > 0) {
+            if (e & 1) {
+                r = r * a % P;
+            }
+            a = a * a % P;
+            e >>= 1;
+        }
+        return static_cast<unsigned>(r);
+    }
+
+    // smallest piece of a pass worth a task of its own
+    constexpr size_t min_piece = size_t(1) << 14;
+
+    // pieces a pass over count elements is cut into: one per thread in parallel, if they are large
+    // enough, and a single one otherwise
+    size_t pieces(size_t count, bool parallel) {
+        return parallel ? std::clamp<size_t>(count / min_piece, 1, parallel::threads()) : 1;
+    }
+
+    // f(piece, from, to) over the pieces of [0, count)
+    template <class F>
+    void for_pieces(size_t count, size_t parts, const F &f) {
+        if (parts == 1) {
+            f(0, 0, count);
+            return;
+        }
+        parallel::for_each(parts, [&](size_t i) {
+            f(i, count * i / parts, count * (i + 1) / parts);
+        });
+    }
+
+    // task(0 .. count), side by side in parallel
+    template <class F>
+    void run_tasks(size_t count, bool parallel, const F &task) {
+        if (parallel) {
+            parallel::for_each(count, task);
+            return;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+    }
+
+    // P = c * 2^k + 1 with primitive root G
+    template <unsigned P, unsigned G>
+    void transform(std::vector<unsigned> &a, bool invert, bool parallel) {
+        size_t n = a.size();
+        size_t parts = pieces(n / 2, parallel);
+        // bit reversal, each piece counting in reverse from the image of its first index
+        for_pieces(n, parts, [&](size_t, size_t from, size_t to) {
+            size_t j = 0;
+            for (size_t bit = n >> 1, i = from; bit > 0; bit >>= 1, i >>= 1) {
+                j |= i & 1 ? bit : 0;
+            }
+            for (size_t i = from; i < to; ++i) {
+                if (i < j) {
+                    std::swap(a[i], a[j]);
+                }
+                size_t bit = n >> 1;
+                for (; j & bit; bit >>= 1) {
+                    j ^= bit;
+                }
+                j ^= bit;
+            }
+        });
+        std::vector<unsigned> roots(n / 2);
+        for (size_t len = 2; len <= n; len <<= 1) {
+            unsigned w = pow_mod<P>(G, (P - 1) / len);
+            if (invert) {
+                w = pow_mod<P>(w, P - 2);
+            }
+            size_t half = len / 2;
+            for_pieces(half, pieces(half, parallel), [&](size_t, size_t from, size_t to) {
+                roots[from] = pow_mod<P>(w, from);
+                for (size_t i = from + 1; i < to; ++i) {
+                    roots[i] = static_cast<unsigned>(static_cast<unsigned long long>(roots[i - 1]) * w % P);
+                }
+            });
+            // butterfly t of the pass joins a[i + j] and a[i + j + half] for i = t / half * len, j = t % half
+            for_pieces(n / 2, parts, [&](size_t, size_t from, size_t to) {
+                for (size_t t = from; t < to;) {
+                    size_t i = t / half * len;
+                    size_t j = t % half;
+                    size_t last = std::min(half, j + (to - t));
+                    t += last - j;
+                    for (; j < last; ++j) {
+                        unsigned u = a[i + j];
+                        unsigned v = static_cast<unsigned>(static_cast<unsigned long long>(a[i + j + half]) * roots[j] % P);
+                        a[i + j] = u + v < P ? u + v : u + v - P;
+                        a[i + j + half] = u >= v ? u - v : u + P - v;
+                    }
+                }
+            });
+        }
+        if (invert) {
+            unsigned long long n_inv = pow_mod<P>(n, P - 2);
+            for_pieces(n, parts, [&](size_t, size_t from, size_t to) {
+                for (size_t i = from; i < to; ++i) {
+                    a[i] = static_cast<unsigned>(a[i] * n_inv % P);
+                }
+            });
+        }
+    }
+
+    template <unsigned P, unsigned G>
+    void convolve(const unsigned long long *a, size_t n, const unsigned long long *b, size_t m,
+                  std::vector<unsigned> &fa, size_t len, bool parallel) {
+        fa.assign(len, 0);
+        for (size_t i = 0; i < n; ++i) {
+            fa[i] = static_cast<unsigned>(a[i] % P);
+        }
+        if (a == b && n == m) {
+            transform<P, G>(fa, false, parallel);
+            for (auto &x : fa) {
+                x = static_cast<unsigned>(static_cast<unsigned long long>(x) * x % P);
+            }
+        } else {
+            std::vector<unsigned> fb(len, 0);
+            for (size_t i = 0; i < m; ++i) {
+                fb[i] = static_cast<unsigned>(b[i] % P);
+            }
+            run_tasks(2, parallel, [&](size_t i) {
+                transform<P, G>(i == 0 ? fa : fb, false, parallel);
+            });
+            for_pieces(len, pieces(len, parallel), [&](size_t, size_t from, size_t to) {
+                for (size_t i = from; i < to; ++i) {
+                    fa[i] = static_cast<unsigned>(static_cast<unsigned long long>(fa[i]) * fb[i] % P);
+                }
+            });
+        }
+        transform<P, G>(fa, true, parallel);
+    }
+
+    constexpr unsigned P1 = 998244353;
+    constexpr unsigned P2 = 167772161;
+    constexpr unsigned P3 = 469762049;
+
+    constexpr size_t binary_digit_bits = 22;
+    constexpr unsigned long long binary_digit_base = 1 << binary_digit_bits;
+
+    size_t binary_digits(size_t limbs) {
+        return (limbs * 64 + binary_digit_bits - 1) / binary_digit_bits;
+    }
+}
+
+bool ntt::fits(size_t n, size_t m, unsigned long long base) {
+    if (base == 0) {
+        return fits(binary_digits(n), binary_digits(m), binary_digit_base);
+    }
+    if (n == 0 || m == 0 || n + m - 1 > max_length) {
+        return false;
+    }
+    uint128 bound = static_cast<uint128>(base - 1) * (base - 1) * std::min(n, m);
+    return bound < static_cast<uint128>(P1) * P2 * P3;
+}
+
+void ntt::multiply(const unsigned long long *a, size_t n, const unsigned long long *b, size_t m,
+                   unsigned long long *res, unsigned long long base, bool parallel) {
+    if (base == 0) {
+        // 2^64 limbs are re-cut into 22-bit digits so that the column sums stay within P1 * P2 * P3
+        auto split = [](const unsigned long long *x, size_t len) {
+            std::vector<unsigned long long> digits(binary_digits(len));
+            for (size_t i = 0; i < digits.size(); ++i) {
+                size_t bit = i * binary_digit_bits;
+                size_t limb = bit / 64;
+                size_t shift = bit % 64;
+                unsigned long long d = x[limb] >> shift;
+                if (shift + binary_digit_bits > 64 && limb + 1 < len) {
+                    d |= x[limb + 1] << (64 - shift);
+                }
+                digits[i] = d & (binary_digit_base - 1);
+            }
+            return digits;
+        };
+        std::vector<unsigned long long> da = split(a, n);
+        // a square stays one, so that only one operand is transformed
+        std::vector<unsigned long long> db = a == b && n == m ? std::vector<unsigned long long>{} : split(b, m);
+        const std::vector<unsigned long long> &rhs = db.empty() ? da : db;
+        std::vector<unsigned long long> dr(da.size() + rhs.size(), 0);
+        multiply(da.data(), da.size(), rhs.data(), rhs.size(), dr.data(), binary_digit_base, parallel);
+        std::fill(res, res + n + m, 0);
+        for (size_t i = 0; i < dr.size(); ++i) {
+            size_t bit = i * binary_digit_bits;
+            size_t limb = bit / 64;
+            size_t shift = bit % 64;
+            if (dr[i] == 0 || limb >= n + m) {
+                continue;
+            }
+            res[limb] |= dr[i] << shift;
+            if (shift + binary_digit_bits > 64 && limb + 1 < n + m) {
+                res[limb + 1] |= dr[i] >> (64 - shift);
+            }
+        }
+        return;
+    }
+    size_t len = 1;
+    while (len < n + m - 1) {
+        len <<= 1;
+    }
+    std::vector<unsigned> r1;
+    std::vector<unsigned> r2;
+    std::vector<unsigned> r3;
+    run_tasks(3, parallel, [&](size_t i) {
+        if (i == 0) {
+            convolve<P1, 3>(a, n, b, m, r1, len, parallel);
+        } else if (i == 1) {
+            convolve<P2, 3>(a, n, b, m, r2, len, parallel);
+        } else {
+            convolve<P3, 3>(a, n, b, m, r3, len, parallel);
+        }
+    });
+
+    // Garner's recombination: x = x1 + x2 * P1 + x3 * P1 * P2. Each piece carries from zero, and the
+    // carries out of the pieces are added in after them
+    const unsigned long long inv_p1 = pow_mod<P2>(P1, P2 - 2);
+    const unsigned long long inv_p1p2 = pow_mod<P3>(static_cast<unsigned long long>(P1) * P2 % P3, P3 - 2);
+    const unsigned long long p1p2 = static_cast<unsigned long long>(P1) * P2;
+    size_t parts = pieces(n + m, parallel);
+    std::vector<uint128> carries(parts);
+    for_pieces(n + m, parts, [&](size_t piece, size_t from, size_t to) {
+        uint128 carry = 0;
+        for (size_t i = from; i < to; ++i) {
+            if (i < n + m - 1) {
+                unsigned long long x1 = r1[i];
+                unsigned long long x2 = (r2[i] + P2 - x1 % P2) * inv_p1 % P2;
+                unsigned long long low = x1 + x2 * P1;
+                unsigned long long x3 = (r3[i] + P3 - low % P3) * inv_p1p2 % P3;
+                carry += low + static_cast<uint128>(x3) * p1p2;
+            }
+            res[i] = static_cast<unsigned long long>(carry % base);
+            carry /= base;
+        }
+        carries[piece] = carry;
+    });
+    for (size_t piece = 0; piece + 1 < parts; ++piece) {
+        uint128 carry = carries[piece];
+        for (size_t i = (n + m) * (piece + 1) / parts; carry; ++i) {
+            carry += res[i];
+            res[i] = static_cast<unsigned long long>(carry % base);
+            carry /= base;
+        }
+    }
+}
@@ -0,0 +1,144 @@
+#include "../include/parallel.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+    // the tasks of one for_each call, handed out by index to whichever thread is free
+    struct Batch {
+        const std::function<void(size_t)> *task;
+        size_t count;
+        size_t next = 0;
+        size_t unfinished;
+        std::exception_ptr error;
+    };
+
+    class Pool {
+        std::mutex mutex;
+        // workers wait for batches, callers for the tasks of theirs that run elsewhere
+        std::condition_variable wake;
+        std::condition_variable finished;
+        // batches with tasks nobody has taken yet
+        std::deque<Batch *> batches;
+        std::vector<std::thread> workers;
+        size_t size = hardware_threads();
+        bool stopping = false;
+
+        static size_t hardware_threads() {
+            return std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        // takes the next task, of batch when it has one left and of the oldest batch otherwise, and
+        // runs it with the lock released
+        void run_one(std::unique_lock<std::mutex> &lock, Batch *batch) {
+            Batch *b = batch && batch->next < batch->count ? batch : batches.front();
+            size_t i = b->next++;
+            if (b->next == b->count) {
+                batches.erase(std::find(batches.begin(), batches.end(), b));
+            }
+            lock.unlock();
+            std::exception_ptr error;
+            try {
+                (*b->task)(i);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            lock.lock();
+            if (error && !b->error) {
+                b->error = error;
+            }
+            if (--b->unfinished == 0) {
+                finished.notify_all();
+            }
+        }
+
+        void work() {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                wake.wait(lock, [this] {
+                    return stopping || !batches.empty();
+                });
+                if (stopping) {
+                    return;
+                }
+                run_one(lock, nullptr);
+            }
+        }
+
+        void stop() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (auto &worker : workers) {
+                worker.join();
+            }
+            workers.clear();
+            stopping = false;
+        }
+
+    public:
+        ~Pool() {
+            stop();
+        }
+
+        void resize(size_t count) {
+            stop();
+            size = count == 0 ? hardware_threads() : count;
+        }
+
+        size_t threads() const {
+            return size;
+        }
+
+        void run(size_t count, const std::function<void(size_t)> &task) {
+            Batch batch{&task, count, 0, count, nullptr};
+            std::unique_lock<std::mutex> lock(mutex);
+            while (workers.size() + 1 < threads()) {
+                workers.emplace_back([this] {
+                    work();
+                });
+            }
+            batches.push_back(&batch);
+            wake.notify_all();
+            while (batch.unfinished > 0) {
+                if (!batches.empty()) {
+                    run_one(lock, &batch);
+                } else {
+                    finished.wait(lock);
+                }
+            }
+            if (batch.error) {
+                std::rethrow_exception(batch.error);
+            }
+        }
+    };
+
+    Pool &pool() {
+        static Pool instance;
+        return instance;
+    }
+}
+
+void parallel::set_threads(size_t count) {
+    pool().resize(count);
+}
+
+size_t parallel::threads() {
+    return pool().threads();
+}
+
+void parallel::for_each(size_t count, const std::function<void(size_t)> &task) {
+    if (count > 1 && threads() > 1) {
+        pool().run(count, task);
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        task(i);
+    }
+}
@@ -1,5 +1,38 @@
 #include <gtest/gtest.h>
 #include "../include/bigint.hpp"
+#include "../include/lazy.hpp"
+#include "../include/mpn.hpp"
+#include "../include/parallel.hpp"
+#include "../include/small_vector.hpp"
+#include <atomic>
+#include <random>
+#include <cstdlib>
+#include <new>
+#include <climits>
+
+namespace {
+    // atomic, since the pool threads of large products allocate too
+    std::atomic<size_t> allocation_count = 0;
+}
+
+[[gnu::noinline]] void *operator new(size_t size) {
+    ++allocation_count;
+    if (void *p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete(void *p, size_t) noexcept {
+    std::free(p);
+}
+
+using Decimal1 = BasicBigInt<unsigned long long, 10>;
+using Decimal3 = BasicBigInt<unsigned long long, 1000>;
 
 class BigIntTest : public ::testing::Test {
 protected:
@@ -138,9 +171,11 @@ TEST_F(BigIntTest, StreamOperations) {
 
 
 TEST_F(BigIntTest, InvalidBaseConversion) {
-    BigInt num("12345");
-    EXPECT_THROW(num.change_base(999), std::invalid_argument);
-    EXPECT_THROW(num.change_base(0), std::invalid_argument);
+    // bases are checked at compile time and a change of radix is never implicit
+    EXPECT_FALSE((std::is_convertible_v<Decimal3, BigInt>));
+    EXPECT_FALSE((std::is_convertible_v<BigInt, Decimal3>));
+    EXPECT_TRUE((std::is_constructible_v<Decimal3, BigInt>));
+    EXPECT_EQ(Decimal3::base_digits, 3);
 }
 
 TEST_F(BigIntTest, IncrementDecrementEdgeCases) {
@@ -195,6 +230,17 @@ TEST_F(BigIntTest, ReloadEdgeCases) {
     EXPECT_EQ(num.to_string(), "0");
 }
 
+TEST_F(BigIntTest, RejectedReloadKeepsOldValue) {
+    BigInt num(5);
+    for (const char *bad : {"12a", "-", "--1", "1 2", "-12345678901234567890x"}) {
+        EXPECT_THROW(num.reload_from_string(bad), std::invalid_argument) << bad;
+        EXPECT_EQ(num, BigInt(5)) << bad;
+    }
+    BigInt big("-123456789012345678901234567890");
+    EXPECT_THROW(big.reload_from_string("99999999999999999999999999999999999999+"), std::invalid_argument);
+    EXPECT_EQ(big.to_string(), "-123456789012345678901234567890");
+}
+
 TEST_F(BigIntTest, FullDivisionCoverage) {
     BigInt a("100"), b("3");
     EXPECT_EQ(a / b, BigInt("33"));
@@ -291,8 +337,8 @@ TEST_F(BigIntTest, ZeroResizeInSubtraction) {
 }
 
 TEST_F(BigIntTest, LargeBaseConversion) {
-    BigInt num("12345678901234567890");
-    num.change_base(1000000000);
+    Decimal1 small("12345678901234567890");
+    BasicBigInt<unsigned long long, 1000000000> num(small);
     EXPECT_EQ(num.to_string(), "12345678901234567890");
 }
 
@@ -325,8 +371,8 @@ TEST_F(BigIntTest, MultiplyByZeroAfterSignChange) {
 }
 
 TEST_F(BigIntTest, ReloadFromStringWithMaxBase) {
-    BigInt num("12345678901234567890");
-    num.change_base(1000000000);
+    BasicBigInt<unsigned long long, 1000000000> num;
+    num.reload_from_string("12345678901234567890");
     EXPECT_EQ(num.to_string(), "12345678901234567890");
 }
 
@@ -349,10 +395,9 @@ TEST_F(BigIntTest, PostfixIncrementDecrementEdge) {
 
 
 TEST_F(BigIntTest, SubtractDifferentBases) {
-    BigInt a("1000");
-    a.change_base(1000);
+    Decimal3 a(BigInt("1000"));
     BigInt b("500");
-    a -= b;
+    a -= Decimal3(b);
     EXPECT_EQ(a.to_string(), "500");
 }
 
@@ -385,11 +430,10 @@ TEST_F(BigIntTest, SubtractWithZeroResize) {
 }
 
 TEST_F(BigIntTest, SubtractWithCarryPropagationInHighDigits) {
-    BigInt a;
-    a.change_base(1000);
+    Decimal3 a;
     a.reload_from_string("100");
 
-    BigInt b("1");
+    Decimal3 b("1");
     a -= b;
 
     EXPECT_EQ(a.to_string(), "99");
@@ -510,6 +554,1252 @@ TEST_F(BigIntTest, ModExpInvalidMod) {
     EXPECT_THROW(BigInt::mod_exp(BigInt(2), BigInt(3), BigInt(0)), std::invalid_argument);
 }
 
+std::string random_digits(std::mt19937_64 &gen, size_t len) {
+    std::uniform_int_distribution<int> digit(0, 9);
+    std::string s(len, '0');
+    for (auto &c : s) {
+        c = static_cast<char>('0' + digit(gen));
+    }
+    s[0] = static_cast<char>('1' + digit(gen) % 9);
+    return s;
+}
+
+class ThresholdGuard {
+    size_t &threshold;
+    size_t saved;
+public:
+    ThresholdGuard(size_t &t, size_t value) : threshold(t), saved(t) {
+        threshold = value;
+    }
+    ~ThresholdGuard() {
+        threshold = saved;
+    }
+};
+
+// puts back the kernels bound when it was made
+class KernelGuard {
+    mpn::kernel add = mpn::add_kernel();
+    mpn::kernel mul = mpn::mul_kernel();
+public:
+    ~KernelGuard() {
+        mpn::use_add_kernel(add);
+        mpn::use_mul_kernel(mul);
+    }
+};
+
+BigInt schoolbook_product(const BigInt &lhs, const BigInt &rhs) {
+    ThresholdGuard guard(BigInt::karatsuba_threshold, SIZE_MAX);
+    // a copy, so that a square goes through the general product as well
+    BigInt copy{rhs};
+    return lhs * copy;
+}
+
+TEST_F(BigIntTest, KaratsubaMatchesSchoolbookAtCutoff) {
+    std::mt19937_64 gen(42);
+    const size_t cutoff = 8;
+    ThresholdGuard guard(BigInt::karatsuba_threshold, cutoff);
+    for (size_t limbs : {cutoff - 1, cutoff, cutoff + 1, 2 * cutoff - 1, 2 * cutoff, 2 * cutoff + 1, 5 * cutoff + 3}) {
+        BigInt x(random_digits(gen, limbs * 9));
+        BigInt y(random_digits(gen, limbs * 9 - 4));
+        EXPECT_EQ(x * y, schoolbook_product(x, y));
+        EXPECT_EQ(x * x, schoolbook_product(x, x));
+    }
+}
+
+template <class Number>
+void check_comba_basecase(std::mt19937_64 &gen) {
+    ThresholdGuard karatsuba(Number::karatsuba_threshold, SIZE_MAX);
+    // binary limbs on a mulx kernel never take the column sums
+    KernelGuard kernels;
+    mpn::use_mul_kernel(mpn::kernel::portable);
+    size_t digits_per_limb = Number::base_digits ? Number::base_digits : 19;
+    for (size_t n : {1, 2, 3, 5, 16, 33, 64}) {
+        for (size_t m : {1, 2, 7, 64}) {
+            // random limbs, and limbs at their maximum where every column carries the most
+            for (bool full : {false, true}) {
+                Number x(random_digits(gen, n * digits_per_limb));
+                Number y(random_digits(gen, m * digits_per_limb));
+                if (full) {
+                    std::vector<unsigned long long> top(std::max(n, m), Number::base - 1);
+                    x.assign_limbs(top.data(), n);
+                    y.assign_limbs(top.data(), m);
+                }
+                Number acc(random_digits(gen, (n + m + 2) * digits_per_limb));
+                Number product;
+                Number square;
+                Number fused = acc;
+                {
+                    ThresholdGuard rows(Number::comba_threshold, SIZE_MAX);
+                    product = x * y;
+                    square = Number::square(x);
+                }
+                ThresholdGuard comba(Number::comba_threshold, 0);
+                EXPECT_EQ(x * y, product);
+                EXPECT_EQ(Number::square(x), square);
+                fused.add_product(x, y);
+                EXPECT_EQ(fused, acc + product);
+            }
+        }
+    }
+}
+
+TEST_F(BigIntTest, CombaBasecaseMatchesRows) {
+    std::mt19937_64 gen(22);
+    check_comba_basecase<Decimal1>(gen);
+    check_comba_basecase<Decimal3>(gen);
+    check_comba_basecase<BasicBigInt<unsigned long long, 1000000000>>(gen);
+    check_comba_basecase<BasicBigInt<unsigned long long, 0>>(gen);
+}
+
+TEST_F(BigIntTest, KaratsubaUnbalancedOperands) {
+    std::mt19937_64 gen(7);
+    ThresholdGuard guard(BigInt::karatsuba_threshold, 4);
+    for (size_t small : {4, 5, 9, 17}) {
+        BigInt x(random_digits(gen, 9 * 50));
+        BigInt y(random_digits(gen, 9 * small));
+        EXPECT_EQ(x * y, schoolbook_product(x, y));
+        EXPECT_EQ(y * x, schoolbook_product(x, y));
+        EXPECT_EQ((-x) * y, -schoolbook_product(x, y));
+    }
+}
+
+TEST_F(BigIntTest, KaratsubaCarryHeavyOperands) {
+    ThresholdGuard guard(BigInt::karatsuba_threshold, 4);
+    BigInt nines(std::string(9 * 40, '9'));
+    BigInt expected = schoolbook_product(nines, nines);
+    EXPECT_EQ(nines * nines, expected);
+    BigInt sparse("1" + std::string(9 * 33, '0') + "1");
+    EXPECT_EQ(sparse * nines, schoolbook_product(sparse, nines));
+}
+
+TEST_F(BigIntTest, Toom3MatchesSchoolbookAtCutoff) {
+    std::mt19937_64 gen(1234);
+    const size_t cutoff = 12;
+    ThresholdGuard karatsuba(BigInt::karatsuba_threshold, 4);
+    ThresholdGuard toom(BigInt::toom3_threshold, cutoff);
+    for (size_t limbs : {cutoff - 1, cutoff, cutoff + 1, 3 * cutoff - 1, 3 * cutoff, 3 * cutoff + 1, 9 * cutoff + 2}) {
+        BigInt x(random_digits(gen, limbs * 9));
+        BigInt y(random_digits(gen, limbs * 9 - 5));
+        EXPECT_EQ(x * y, schoolbook_product(x, y));
+        EXPECT_EQ(x * (-y), -schoolbook_product(x, y));
+    }
+}
+
+TEST_F(BigIntTest, Toom3Squaring) {
+    std::mt19937_64 gen(99);
+    ThresholdGuard karatsuba(BigInt::karatsuba_threshold, 4);
+    ThresholdGuard toom(BigInt::toom3_threshold, 6);
+    for (size_t limbs : {6, 7, 8, 20, 61}) {
+        BigInt x(random_digits(gen, limbs * 9));
+        EXPECT_EQ(x * x, schoolbook_product(x, x));
+    }
+    BigInt nines(std::string(9 * 70, '9'));
+    EXPECT_EQ(nines * nines, schoolbook_product(nines, nines));
+}
+
+TEST_F(BigIntTest, Toom3UnevenSplit) {
+    std::mt19937_64 gen(5);
+    ThresholdGuard karatsuba(BigInt::karatsuba_threshold, 4);
+    ThresholdGuard toom(BigInt::toom3_threshold, 5);
+    for (size_t small : {5, 6, 13, 26}) {
+        BigInt x(random_digits(gen, 9 * 27));
+        BigInt y(random_digits(gen, 9 * small + 3));
+        EXPECT_EQ(x * y, schoolbook_product(x, y));
+    }
+    BigInt sparse("1" + std::string(9 * 40, '0'));
+    BigInt dense(random_digits(gen, 9 * 30));
+    EXPECT_EQ(sparse * dense, schoolbook_product(sparse, dense));
+}
+
+TEST_F(BigIntTest, SquareMatchesProductOnEveryTier) {
+    std::mt19937_64 gen(13);
+    ThresholdGuard karatsuba(BigInt::karatsuba_threshold, 4);
+    ThresholdGuard toom(BigInt::toom3_threshold, 12);
+    ThresholdGuard ntt(BigInt::ntt_threshold, 40);
+    for (size_t limbs : {1, 3, 4, 5, 11, 12, 13, 39, 40, 41, 97}) {
+        BigInt x(random_digits(gen, limbs * 9));
+        BigInt expected = schoolbook_product(x, x);
+        EXPECT_EQ(BigInt::square(x), expected);
+        EXPECT_EQ(BigInt::square(-x), expected);
+        EXPECT_EQ(x * x, expected);
+        BigInt nines(std::string(limbs * 9, '9'));
+        EXPECT_EQ(BigInt::square(nines), schoolbook_product(nines, nines));
+    }
+    EXPECT_EQ(BigInt::square(BigInt(0)), BigInt(0));
+    BigInt sparse("1" + std::string(9 * 30, '0') + "1");
+    EXPECT_EQ(BigInt::square(sparse), schoolbook_product(sparse, sparse));
+}
+
+TEST_F(BigIntTest, NttMatchesSchoolbook) {
+    std::mt19937_64 gen(2024);
+    ThresholdGuard ntt(BigInt::ntt_threshold, 4);
+    for (size_t limbs : {4, 5, 31, 32, 33, 200}) {
+        BigInt x(random_digits(gen, limbs * 9));
+        BigInt y(random_digits(gen, limbs * 9 - 2));
+        EXPECT_EQ(x * y, schoolbook_product(x, y));
+        EXPECT_EQ(x * x, schoolbook_product(x, x));
+    }
+}
+
+TEST_F(BigIntTest, NttUnbalancedAndCarryHeavy) {
+    std::mt19937_64 gen(77);
+    ThresholdGuard ntt(BigInt::ntt_threshold, 4);
+    BigInt x(random_digits(gen, 9 * 300));
+    BigInt y(random_digits(gen, 9 * 6 + 1));
+    EXPECT_EQ(x * y, schoolbook_product(x, y));
+    EXPECT_EQ((-y) * x, -schoolbook_product(x, y));
+
+    BigInt nines(std::string(9 * 257, '9'));
+    EXPECT_EQ(nines * nines, schoolbook_product(nines, nines));
+}
+
+// runs the test on count threads, whatever the machine has
+class ThreadsGuard {
+    size_t saved = parallel::threads();
+public:
+    explicit ThreadsGuard(size_t count) {
+        parallel::set_threads(count);
+    }
+    ~ThreadsGuard() {
+        parallel::set_threads(saved);
+    }
+};
+
+TEST_F(BigIntTest, ParallelForEachRunsEveryTaskOnce) {
+    ThreadsGuard threads(4);
+    std::array<std::atomic<int>, 64> runs{};
+    // nested, as the tiers of a product are
+    parallel::for_each(8, [&](size_t i) {
+        parallel::for_each(8, [&](size_t j) {
+            ++runs[i * 8 + j];
+        });
+    });
+    EXPECT_TRUE(std::all_of(runs.begin(), runs.end(), [](const std::atomic<int> &count) { return count == 1; }));
+
+    EXPECT_THROW(parallel::for_each(5, [](size_t i) {
+        if (i == 3) {
+            throw std::invalid_argument("task");
+        }
+    }), std::invalid_argument);
+    std::atomic<size_t> sum = 0;
+    parallel::for_each(100, [&](size_t i) {
+        sum += i;
+    });
+    EXPECT_EQ(sum, 4950u);
+}
+
+TEST_F(BigIntTest, ParallelProductsMatchSerial) {
+    std::mt19937_64 gen(25);
+    ThreadsGuard threads(4);
+    ThresholdGuard karatsuba(BigInt::karatsuba_threshold, 4);
+    ThresholdGuard toom(BigInt::toom3_threshold, 12);
+    ThresholdGuard ntt(BigInt::ntt_threshold, 300);
+    // Karatsuba, Toom-3, unbalanced and NTT products split down to small subproducts
+    for (size_t limbs : {5, 13, 40, 150, 400}) {
+        BigInt x(random_digits(gen, limbs * 9));
+        BigInt y(random_digits(gen, limbs * 9 - 5));
+        BigInt wide(random_digits(gen, limbs * 9 * 5));
+        BigInt product;
+        BigInt square;
+        BigInt unbalanced;
+        {
+            ThresholdGuard serial(BigInt::parallel_threshold, SIZE_MAX);
+            product = x * y;
+            square = BigInt::square(x);
+            unbalanced = wide * y;
+        }
+        ThresholdGuard parallel(BigInt::parallel_threshold, 4);
+        EXPECT_EQ(x * y, product);
+        EXPECT_EQ(BigInt::square(x), square);
+        EXPECT_EQ(wide * y, unbalanced);
+    }
+
+    // transforms long enough to be cut into pieces, and carry-heavy limbs for the recombination
+    for (char digit : {'0', '9'}) {
+        BigInt x(digit == '0' ? random_digits(gen, 300000) : std::string(300000, '9'));
+        BigInt y(digit == '0' ? random_digits(gen, 250000) : std::string(250000, '9'));
+        BigInt product;
+        BigInt square;
+        {
+            ThresholdGuard serial(BigInt::parallel_threshold, SIZE_MAX);
+            product = x * y;
+            square = BigInt::square(y);
+        }
+        EXPECT_EQ(x * y, product);
+        EXPECT_EQ(BigInt::square(y), square);
+    }
+}
+
+TEST_F(BigIntTest, DivisionQuotientRemainderIdentity) {
+    std::mt19937_64 gen(31337);
+    for (size_t len : {1, 9, 10, 40, 95, 400}) {
+        for (size_t dlen : {1, 2, 9, 18, 27, 60}) {
+            BigInt x(random_digits(gen, len));
+            BigInt y(random_digits(gen, dlen));
+            BigInt q = x / y;
+            BigInt r = x % y;
+            EXPECT_EQ(q * y + r, x);
+            EXPECT_LT(r, y);
+            EXPECT_EQ((-x) / y, -q);
+            EXPECT_EQ((-x) % y, -r);
+        }
+    }
+}
+
+template <class Number>
+void check_small_base_division(std::mt19937_64 &gen) {
+    for (int i = 0; i < 200; ++i) {
+        Number x(random_digits(gen, 30 + i % 17));
+        Number y(random_digits(gen, 2 + i % 13));
+        Number q = x / y;
+        Number r = x % y;
+        EXPECT_EQ(q * y + r, x);
+        EXPECT_LT(r, y);
+    }
+}
+
+TEST_F(BigIntTest, DivisionSmallBaseCorrections) {
+    // a small base makes the rare add-back step of Algorithm D common
+    std::mt19937_64 gen(8);
+    check_small_base_division<Decimal1>(gen);
+    check_small_base_division<Decimal3>(gen);
+}
+
+TEST_F(BigIntTest, DivisionByPowersOfBase) {
+    BigInt x("123456789123456789123456789123456789");
+    EXPECT_EQ(x / BigInt("1000000000"), BigInt("123456789123456789123456789"));
+    EXPECT_EQ(x % BigInt("1000000000000000000"), BigInt("123456789123456789"));
+    BigInt nines(std::string(90, '9'));
+    EXPECT_EQ(nines / BigInt(std::string(45, '9')), BigInt("1" + std::string(44, '0') + "1"));
+    EXPECT_EQ(nines % BigInt(std::string(45, '9')), BigInt(0));
+}
+
+std::pair<BigInt, BigInt> knuth_divmod(const BigInt &lhs, const BigInt &rhs) {
+    ThresholdGuard guard(BigInt::burnikel_ziegler_threshold, SIZE_MAX);
+    return {lhs / rhs, lhs % rhs};
+}
+
+TEST_F(BigIntTest, BurnikelZieglerMatchesKnuth) {
+    std::mt19937_64 gen(4242);
+    for (size_t threshold : {4, 5, 8}) {
+        ThresholdGuard guard(BigInt::burnikel_ziegler_threshold, threshold);
+        for (size_t dlimbs : {threshold, threshold + 1, 2 * threshold + 3, 7 * threshold}) {
+            BigInt y(random_digits(gen, dlimbs * 9 - 3));
+            for (size_t extra : {threshold, 3 * threshold + 1, 10 * threshold}) {
+                BigInt x(random_digits(gen, (dlimbs + extra) * 9));
+                auto expected = knuth_divmod(x, y);
+                EXPECT_EQ(x / y, expected.first);
+                EXPECT_EQ(x % y, expected.second);
+            }
+        }
+    }
+}
+
+TEST_F(BigIntTest, BurnikelZieglerSaturatedQuotient) {
+    // dividends just below a multiple of the divisor push the top quotient blocks to their maximum
+    std::mt19937_64 gen(17);
+    ThresholdGuard guard(BigInt::burnikel_ziegler_threshold, 4);
+    BigInt y(random_digits(gen, 9 * 16));
+    BigInt x = y * BigInt("1" + std::string(9 * 48, '0')) - BigInt(1);
+    EXPECT_EQ(x / y, BigInt(std::string(9 * 48, '9')));
+    EXPECT_EQ(x % y, y - BigInt(1));
+
+    BigInt nines(std::string(9 * 64, '9'));
+    BigInt divisor("1" + std::string(9 * 20, '0') + "1");
+    auto expected = knuth_divmod(nines, divisor);
+    EXPECT_EQ(nines / divisor, expected.first);
+    EXPECT_EQ(nines % divisor, expected.second);
+}
+
+TEST_F(BigIntTest, ComparisonOfNegativeNumbers) {
+    EXPECT_LT(BigInt(-10), BigInt(-5));
+    EXPECT_GT(BigInt("-999999999"), BigInt("-1000000000"));
+    EXPECT_LT(BigInt("-123456789012345678901234567891"), BigInt("-123456789012345678901234567890"));
+    EXPECT_EQ(BigInt("-0"), BigInt(0));
+    EXPECT_LE(b, b);
+    EXPECT_GE(-b, a);
+}
+
+TEST_F(BigIntTest, ComparisonAcrossBases) {
+    BigInt x("123456789123456789");
+    Decimal3 y("123456789123456789");
+    EXPECT_EQ(x, BigInt(y));
+    EXPECT_EQ(y, Decimal3(x));
+    EXPECT_LT(x, BigInt(y + Decimal3(1)));
+    EXPECT_GT(-x, -BigInt(y + Decimal3(1)));
+}
+
+TEST_F(BigIntTest, ConversionBetweenEveryRadix) {
+    using Binary = BasicBigInt<unsigned long long, 0>;
+    using Decimal9 = BasicBigInt<unsigned long long, 1000000000>;
+    std::mt19937_64 gen(16);
+    std::vector<std::string> values{"0", "-1", "999999999", "1000000000", "18446744073709551616",
+                                    "-10000000000000000000"};
+    for (size_t digits : {20, 37, 500, 9000, 30000}) {
+        std::string str = random_digits(gen, digits);
+        values.push_back(str);
+        values.push_back(std::string(1, '-').append(str));
+    }
+    for (const auto &str : values) {
+        Decimal1 d1(str);
+        Decimal3 d3(str);
+        Decimal9 d9(str);
+        Binary bin(str);
+        EXPECT_EQ(Decimal1(d3), d1);
+        EXPECT_EQ(Decimal1(d9), d1);
+        EXPECT_EQ(Decimal1(bin), d1);
+        EXPECT_EQ(Decimal3(d1), d3);
+        EXPECT_EQ(Decimal3(d9), d3);
+        EXPECT_EQ(Decimal3(bin), d3);
+        EXPECT_EQ(Decimal9(d1), d9);
+        EXPECT_EQ(Decimal9(d3), d9);
+        EXPECT_EQ(Decimal9(bin), d9);
+        EXPECT_EQ(Binary(d1), bin);
+        EXPECT_EQ(Binary(d3), bin);
+        EXPECT_EQ(Binary(d9), bin);
+    }
+}
+
+TEST_F(BigIntTest, ComparisonSortsLikeIntegers) {
+    std::mt19937_64 gen(3);
+    std::vector<long long> values;
+    std::vector<BigInt> nums;
+    for (int i = 0; i < 500; ++i) {
+        long long v = static_cast<long long>(gen() % 4000000000000ULL) - 2000000000000LL;
+        values.push_back(v);
+        nums.emplace_back(v);
+    }
+    std::sort(values.begin(), values.end());
+    std::sort(nums.begin(), nums.end());
+    for (size_t i = 0; i < values.size(); ++i) {
+        EXPECT_EQ(nums[i], BigInt(values[i]));
+    }
+}
+
+TEST_F(BigIntTest, InPlaceAdditionSubtraction) {
+    std::mt19937_64 gen(21);
+    for (int i = 0; i < 100; ++i) {
+        BigInt x(random_digits(gen, 1 + gen() % 60));
+        BigInt y(random_digits(gen, 1 + gen() % 60));
+        if (gen() % 2) {
+            x = -x;
+        }
+        if (gen() % 2) {
+            y = -y;
+        }
+        BigInt sum = x;
+        sum += y;
+        BigInt diff = x;
+        diff -= y;
+        EXPECT_EQ(sum - y, x);
+        EXPECT_EQ(diff + y, x);
+        EXPECT_EQ(sum + diff, x + x);
+        EXPECT_EQ(sum - diff, y + y);
+    }
+    BigInt self("999999999999999999");
+    self += self;
+    EXPECT_EQ(self, BigInt("1999999999999999998"));
+    self -= self;
+    EXPECT_EQ(self, BigInt(0));
+}
+
+TEST_F(BigIntTest, WarmAccumulatorDoesNotAllocate) {
+    BigInt acc("-" + std::string(90, '9'));
+    BigInt step("123456789123456789123456789");
+    BigInt negative_step = -step;
+    acc += negative_step;
+    acc -= negative_step;
+    acc -= negative_step;
+    acc += negative_step;
+
+    size_t before = allocation_count;
+    for (int i = 0; i < 1000; ++i) {
+        acc += step;
+        acc -= negative_step;
+        acc += negative_step;
+        acc -= step;
+    }
+    EXPECT_EQ(allocation_count, before);
+    EXPECT_EQ(acc, BigInt("-" + std::string(90, '9')));
+}
+
+template <class Number>
+void check_word_operands(std::mt19937_64 &gen) {
+    std::vector<long long> signed_words{1, -1, 7, -10, 97, 999999999, -1000000000, LLONG_MAX, LLONG_MIN};
+    std::vector<unsigned long long> unsigned_words{1, 10, 1000, 4294967296ULL, 10000000000000000000ULL, ULLONG_MAX};
+    for (int i = 0; i < 40; ++i) {
+        signed_words.push_back(static_cast<long long>(gen()));
+        unsigned_words.push_back((gen() >> (gen() % 64)) | 1);
+    }
+    for (int i = 0; i < 30; ++i) {
+        Number x(random_digits(gen, 1 + gen() % 80));
+        if (i % 3 == 0) {
+            x = -x;
+        }
+        if (i == 0) {
+            x = Number(0);
+        }
+        for (long long w : signed_words) {
+            Number big(w);
+            EXPECT_EQ(x + w, x + big);
+            EXPECT_EQ(x - w, x - big);
+            EXPECT_EQ(x * w, x * big);
+            EXPECT_EQ(x / w, x / big);
+            EXPECT_EQ(x % w, x % big);
+            EXPECT_EQ(w + x, x + big);
+            EXPECT_EQ(w * x, x * big);
+        }
+        for (unsigned long long w : unsigned_words) {
+            Number big(std::to_string(w));
+            EXPECT_EQ(x + w, x + big);
+            EXPECT_EQ(x - w, x - big);
+            EXPECT_EQ(x * w, x * big);
+            EXPECT_EQ(x / w, x / big);
+            EXPECT_EQ(x % w, x % big);
+        }
+    }
+}
+
+TEST_F(BigIntTest, WordOperandsMatchBigIntOperands) {
+    std::mt19937_64 gen(17);
+    check_word_operands<Decimal1>(gen);
+    check_word_operands<Decimal3>(gen);
+    check_word_operands<BasicBigInt<unsigned long long, 1000000000>>(gen);
+    check_word_operands<BasicBigInt<unsigned long long, 0>>(gen);
+
+    BigInt x("123456789");
+    EXPECT_EQ(x * 10 + 7, BigInt("1234567897"));
+    EXPECT_EQ(x % 97, BigInt(123456789 % 97));
+    EXPECT_EQ(x + 0, x);
+    EXPECT_EQ(x * 0u, BigInt(0));
+    EXPECT_EQ(-x % -97, BigInt(-x % BigInt(-97)));
+    EXPECT_THROW(x / 0, std::invalid_argument);
+    EXPECT_THROW(x % 0ull, std::invalid_argument);
+}
+
+// T works with BigInt on either side of each operator
+template <class T>
+concept integer_operand = requires(BigInt x, T v) {
+    x + v; x - v; x * v; x / v; x % v;
+    v + x; v - x; v * x; v / x; v % x;
+    x += v; x -= v; x *= v; x /= v; x %= v;
+};
+
+// not a single operator takes T
+template <class T>
+concept no_operator_takes = !requires(BigInt x, T v) { x + v; } && !requires(BigInt x, T v) { x - v; } &&
+    !requires(BigInt x, T v) { x * v; } && !requires(BigInt x, T v) { x / v; } &&
+    !requires(BigInt x, T v) { x % v; } && !requires(BigInt x, T v) { v + x; } &&
+    !requires(BigInt x, T v) { v - x; } && !requires(BigInt x, T v) { v * x; } &&
+    !requires(BigInt x, T v) { v / x; } && !requires(BigInt x, T v) { v % x; } &&
+    !requires(BigInt x, T v) { x += v; } && !requires(BigInt x, T v) { x -= v; } &&
+    !requires(BigInt x, T v) { x *= v; } && !requires(BigInt x, T v) { x /= v; } &&
+    !requires(BigInt x, T v) { x %= v; };
+
+template <class... T>
+constexpr bool no_integer_operand = (no_operator_takes<T> && ...);
+
+TEST_F(BigIntTest, IntegerOnTheLeftMatchesBigIntOperands) {
+    BigInt big("123456789012345678901234567890");
+    for (const BigInt &x : {BigInt(7), BigInt(-7), BigInt(123456789), big, -big}) {
+        EXPECT_EQ(5 + x, BigInt(5) + x);
+        EXPECT_EQ(5 * x, BigInt(5) * x);
+        EXPECT_EQ(5 - x, BigInt(5) - x);
+        EXPECT_EQ(-1000000007ll / x, BigInt(-1000000007) / x);
+        EXPECT_EQ(1000000007u % x, BigInt(1000000007) % x);
+        EXPECT_EQ(LLONG_MIN - x, BigInt(LLONG_MIN) - x);
+        EXPECT_EQ(ULLONG_MAX * x, BigInt("18446744073709551615") * x);
+        EXPECT_EQ(ULLONG_MAX / x, BigInt("18446744073709551615") / x);
+    }
+    EXPECT_THROW(7 / BigInt(0), std::invalid_argument);
+    EXPECT_THROW(7 % BigInt(0), std::invalid_argument);
+
+    static_assert(integer_operand<short> && integer_operand<unsigned long long>);
+    static_assert(no_integer_operand<bool, char, signed char, unsigned char, wchar_t, char8_t, char16_t,
+                                     char32_t>);
+}
+
+TEST_F(BigIntTest, IncrementCarriesAcrossLimbs) {
+    BigInt x(std::string(60, '9'));
+    BigInt up = x;
+    ++up;
+    EXPECT_EQ(up, BigInt("1" + std::string(60, '0')));
+    EXPECT_EQ(--up, x);
+    BigInt y(-1);
+    EXPECT_EQ(++y, BigInt(0));
+    EXPECT_EQ(--y, BigInt(-1));
+
+    // a warm counter steps in place
+    BigInt counter("1" + std::string(50, '0'));
+    ++counter;
+    size_t before = allocation_count;
+    for (int i = 0; i < 1000; ++i) {
+        ++counter;
+        counter += 5;
+        counter -= 3u;
+    }
+    EXPECT_EQ(allocation_count, before);
+    EXPECT_EQ(counter, BigInt("1" + std::string(46, '0') + "3001"));
+}
+
+TEST_F(BigIntTest, SmallValuesDoNotAllocate) {
+    // every value and product below stays within the inline limbs
+    size_t before = allocation_count;
+    BigInt x;
+    BigInt y(LLONG_MIN);
+    BigInt z(123456789012345678LL);
+    BigInt copy = y;
+    BigInt moved = std::move(copy);
+    swap(moved, z);
+    x = y + z;
+    x -= moved;
+    x %= 1000000;
+    x = x * z;
+    x /= 7;
+    x %= z;
+    ++x;
+    EXPECT_EQ(allocation_count, before);
+    EXPECT_EQ(z, BigInt(LLONG_MIN));
+    EXPECT_EQ(x, (((y + z - moved) % BigInt(1000000) * z) / BigInt(7)) % z + BigInt(1));
+}
+
+TEST_F(BigIntTest, SpilledLimbsSurviveCopyMoveAndSwap) {
+    std::mt19937_64 gen(18);
+    BigInt small(42);
+    for (size_t digits : {10, 36, 37, 200}) {
+        std::string str = random_digits(gen, digits);
+        BigInt x(str);
+        BigInt copy = x;
+        BigInt moved = std::move(copy);
+        EXPECT_EQ(moved.to_string(), str);
+        swap(moved, small);
+        EXPECT_EQ(small.to_string(), str);
+        EXPECT_EQ(moved, BigInt(42));
+        swap(moved, small);
+        BigInt assigned;
+        assigned = moved;
+        EXPECT_EQ(assigned, x);
+        // growing past the inline limbs and shrinking back keeps the value
+        BigInt grown = x * x * x;
+        EXPECT_EQ(grown / x / x, x);
+    }
+}
+
+TEST_F(BigIntTest, SmallVectorAppendEraseAndResizeFromItself) {
+    SmallVector<unsigned long long, 4> v{1, 2, 3};
+    // the source aliases the buffer that append has to grow
+    v.append(v.begin(), v.end());
+    EXPECT_EQ(v, (SmallVector<unsigned long long, 4>{1, 2, 3, 1, 2, 3}));
+    v.erase_prefix(2);
+    EXPECT_EQ(v, (SmallVector<unsigned long long, 4>{3, 1, 2, 3}));
+    // the fill value is an element, read before the inline buffer is left behind
+    v.resize(9, v[0]);
+    EXPECT_EQ(v, (SmallVector<unsigned long long, 4>{3, 1, 2, 3, 3, 3, 3, 3, 3}));
+    v.resize(40, v[8]);
+    EXPECT_EQ(v.size(), 40u);
+    EXPECT_TRUE(std::all_of(v.begin() + 4, v.end(), [](unsigned long long x) {
+        return x == 3;
+    }));
+    v.erase_prefix(v.size());
+    EXPECT_TRUE(v.empty());
+}
+
+TEST_F(BigIntTest, ExpressionChainsReuseTemporaries) {
+    std::mt19937_64 gen(19);
+    BigInt a(random_digits(gen, 100));
+    BigInt b(random_digits(gen, 100));
+    BigInt c(random_digits(gen, 100));
+    BigInt d(random_digits(gen, 100));
+    BigInt expected = a;
+    expected += b;
+    expected += c;
+    expected += d;
+
+    // one copy of a, then every step works in the temporary
+    size_t before = allocation_count;
+    BigInt sum = a + b + c + d;
+    EXPECT_EQ(allocation_count, before + 1);
+    EXPECT_EQ(sum, expected);
+
+    before = allocation_count;
+    BigInt mixed = std::move(sum) - a - b + 7 - d;
+    BigInt reduced = std::move(mixed) % 1000000007;
+    EXPECT_EQ(allocation_count, before);
+    EXPECT_EQ(reduced, (c + BigInt(7)) % BigInt(1000000007));
+
+    // move assignment hands the limbs over and leaves zero behind
+    BigInt target;
+    before = allocation_count;
+    target = std::move(c);
+    EXPECT_EQ(allocation_count, before);
+    EXPECT_EQ(c, BigInt(0));
+    EXPECT_EQ(target + BigInt(7), expected - a - b - d + BigInt(7));
+}
+
+template <class Number>
+void check_fused_expressions(std::mt19937_64 &gen) {
+    // digit counts on both sides of the Karatsuba threshold, and a zero
+    for (size_t digits : {0, 1, 9, 30, 150, 700, 3000}) {
+        Number a(digits ? random_digits(gen, digits) : "0");
+        Number b(random_digits(gen, 1 + gen() % 200));
+        Number c(random_digits(gen, 1 + gen() % 400));
+        Number m(random_digits(gen, 1 + gen() % 100));
+        for (int signs = 0; signs < 8; ++signs) {
+            Number x = signs & 1 ? -a : a;
+            Number y = signs & 2 ? -b : b;
+            Number z = signs & 4 ? -c : c;
+            Number acc = z;
+            acc += lazy(x) * y;
+            EXPECT_EQ(acc, z + x * y);
+            acc -= lazy(x) * y;
+            EXPECT_EQ(acc, z);
+            EXPECT_EQ(lazy(x) * y + z, z + x * y);
+            EXPECT_EQ(z - lazy(x) * y, z - x * y);
+            EXPECT_EQ(lazy(x) * y % m, x * y % m);
+            EXPECT_EQ(lazy(x) * y % -m, x * y % -m);
+            EXPECT_EQ(Number(lazy(x) - y + z - x - z - m + y), -m);
+            EXPECT_EQ(Number(lazy(z) - x - y - m - m), z - x - y - m - m);
+        }
+    }
+}
+
+TEST_F(BigIntTest, FusedExpressionsMatchPlainOperators) {
+    std::mt19937_64 gen(20);
+    check_fused_expressions<Decimal1>(gen);
+    check_fused_expressions<Decimal3>(gen);
+    check_fused_expressions<BasicBigInt<unsigned long long, 1000000000>>(gen);
+    check_fused_expressions<BasicBigInt<unsigned long long, 0>>(gen);
+
+    // an accumulator may appear in its own product
+    BigInt acc("-123456789123456789123456789");
+    BigInt expected = acc + acc * b;
+    acc += lazy(acc) * b;
+    EXPECT_EQ(acc, expected);
+    EXPECT_EQ(BigInt(lazy(a) * a), a * a);
+    EXPECT_EQ(BigInt(lazy(a) + a - b), a + a - b);
+    EXPECT_THROW(lazy(a) * b % zero, std::invalid_argument);
+
+    // a short product adds its rows into the accumulator without a product buffer
+    BigInt row("1" + std::string(20, '0'));
+    BigInt warm(std::string(60, '9'));
+    warm += lazy(row) * row;
+    size_t before = allocation_count;
+    warm += lazy(row) * row;
+    EXPECT_EQ(allocation_count, before);
+    EXPECT_EQ(warm, BigInt(std::string(60, '9')) + row * row + row * row);
+
+    // the fused binary forms allocate no more than the same sum written out by hand
+    BigInt x(random_digits(gen, 200));
+    BigInt y(random_digits(gen, 200));
+    BigInt z(random_digits(gen, 200));
+    auto allocations = [](auto expression) {
+        size_t start = allocation_count;
+        expression();
+        return allocation_count - start;
+    };
+    size_t added = allocations([&] {
+        BigInt manual = z;
+        manual += lazy(x) * y;
+    });
+    size_t subtracted = allocations([&] {
+        BigInt manual = z;
+        manual -= lazy(x) * y;
+    });
+    EXPECT_EQ(allocations([&] {
+        BigInt fused = lazy(x) * y + z;
+    }), added);
+    EXPECT_EQ(allocations([&] {
+        BigInt fused = z + lazy(x) * y;
+    }), added);
+    EXPECT_EQ(allocations([&] {
+        BigInt fused = z - lazy(x) * y;
+    }), subtracted);
+    EXPECT_EQ(BigInt(z - lazy(x) * y), z - x * y);
+}
+
+template <unsigned long long Base>
+void check_limb_layer(std::mt19937_64 &gen) {
+    using Number = BasicBigInt<unsigned long long, Base>;
+    using mpn::limb_t;
+    // lengths on both sides of the Karatsuba and Burnikel-Ziegler thresholds in every radix
+    for (size_t digits : {1, 7, 40, 300, 2500}) {
+        for (int i = 0; i < 4; ++i) {
+            Number x(random_digits(gen, digits + gen() % 20));
+            Number y(random_digits(gen, 1 + gen() % (digits + 20)));
+            if (x < y) {
+                swap(x, y);
+            }
+            size_t n = x.limb_count();
+            size_t m = y.limb_count();
+            std::vector<limb_t> u(x.limbs(), x.limbs() + n);
+            std::vector<limb_t> v(n, 0);
+            std::copy(y.limbs(), y.limbs() + m, v.begin());
+            std::vector<limb_t> r(n + 1);
+            Number res;
+
+            r[n] = mpn::add_n<Base>(r.data(), u.data(), v.data(), n);
+            res.assign_limbs(r.data(), r.size());
+            EXPECT_EQ(res, x + y);
+            EXPECT_EQ(mpn::sub_n<Base>(r.data(), u.data(), v.data(), n), 0u);
+            res.assign_limbs(r.data(), n);
+            EXPECT_EQ(res, x - y);
+            EXPECT_EQ(mpn::sub_n<Base>(r.data(), v.data(), u.data(), n), x == y ? 0u : 1u);
+
+            limb_t w = gen();
+            if constexpr (Base != 0) {
+                w %= Base;
+            }
+            r[n] = mpn::mul_1<Base>(r.data(), u.data(), n, w);
+            res.assign_limbs(r.data(), r.size());
+            EXPECT_EQ(res, x * w);
+            std::copy(v.begin(), v.end(), r.begin());
+            r[n] = mpn::addmul_1<Base>(r.data(), u.data(), n, w);
+            res.assign_limbs(r.data(), r.size());
+            EXPECT_EQ(res, y + x * w);
+
+            std::vector<limb_t> product(n + m);
+            mpn::mul<Base>(product.data(), u.data(), n, y.limbs(), m);
+            res.assign_limbs(product.data(), product.size(), true);
+            EXPECT_EQ(res, -(x * y));
+
+            limb_t d = (gen() >> (gen() % 64)) | 1;
+            limb_t rem = mpn::divrem_1<Base>(r.data(), u.data(), n, d);
+            res.assign_limbs(r.data(), n);
+            EXPECT_EQ(res, x / d);
+            EXPECT_EQ(Number(std::to_string(rem)), x % d);
+
+            std::vector<limb_t> q(n - m + 1);
+            std::vector<limb_t> scratch(mpn::divrem_itch(n, m));
+            mpn::divrem<Base>(q.data(), r.data(), u.data(), n, y.limbs(), m, scratch.data());
+            res.assign_limbs(q.data(), q.size());
+            EXPECT_EQ(res, x / y);
+            res.assign_limbs(r.data(), m);
+            EXPECT_EQ(res, x % y);
+        }
+    }
+}
+
+TEST_F(BigIntTest, LimbLayerMatchesOperators) {
+    std::mt19937_64 gen(21);
+    check_limb_layer<10>(gen);
+    check_limb_layer<1000>(gen);
+    check_limb_layer<1000000000>(gen);
+    check_limb_layer<0>(gen);
+}
+
+TEST_F(BigIntTest, LimbLayerLoopsRunInCallerBuffers) {
+    using mpn::limb_t;
+    constexpr limb_t base = BigInt::base;
+    // 200! and back, in buffers sized once up front
+    std::vector<limb_t> acc(400, 0);
+    std::vector<limb_t> q(400);
+    std::vector<limb_t> rem(400);
+    std::vector<limb_t> scratch(mpn::divrem_itch(400, 3));
+    const limb_t divisor[3] = {1, 2, 3};
+    BigInt expected(1);
+    for (int k = 2; k <= 200; ++k) {
+        expected *= k;
+    }
+    acc[0] = 1;
+    size_t size = 1;
+    size_t before = allocation_count;
+    for (limb_t k = 2; k <= 200; ++k) {
+        acc[size] = mpn::mul_1<base>(acc.data(), acc.data(), size, k);
+        size += acc[size] != 0;
+    }
+    mpn::divrem<base>(q.data(), rem.data(), acc.data(), size, divisor, 3, scratch.data());
+    limb_t last = 0;
+    for (limb_t k = 200; k >= 2; --k) {
+        last |= mpn::divrem_1<base>(acc.data(), acc.data(), size, k);
+    }
+    EXPECT_EQ(allocation_count, before);
+    EXPECT_EQ(last, 0u);
+    EXPECT_EQ(acc[0], 1u);
+    EXPECT_TRUE(std::all_of(acc.begin() + 1, acc.end(), [](limb_t limb) { return limb == 0; }));
+
+    BigInt three_limbs;
+    three_limbs.assign_limbs(divisor, 3);
+    BigInt quotient;
+    quotient.assign_limbs(q.data(), size - 2);
+    BigInt remainder;
+    remainder.assign_limbs(rem.data(), 3);
+    EXPECT_EQ(quotient, expected / three_limbs);
+    EXPECT_EQ(remainder, expected % three_limbs);
+}
+
+template <mpn::limb_t Base>
+void check_add_kernels(std::mt19937_64 &gen) {
+    using mpn::limb_t;
+    const limb_t top = Base == 0 ? ~limb_t{0} : Base - 1;
+    // limbs mostly at the ends of the range, so that carries and borrows ripple through long runs
+    auto draw = [&]() -> limb_t {
+        switch (gen() % 4) {
+            case 0:
+                return top;
+            case 1:
+                return 0;
+            default:
+                return Base == 0 ? gen() : gen() % Base;
+        }
+    };
+    for (size_t n : {8, 9, 12, 15, 16, 17, 31, 33, 64, 101, 1000}) {
+        std::vector<limb_t> u(n);
+        std::vector<limb_t> v(n);
+        std::generate(u.begin(), u.end(), draw);
+        std::generate(v.begin(), v.end(), draw);
+        mpn::use_add_kernel(mpn::kernel::portable);
+        std::vector<limb_t> sum(n);
+        std::vector<limb_t> diff(n);
+        limb_t carry = mpn::add_n<Base>(sum.data(), u.data(), v.data(), n);
+        limb_t borrow = mpn::sub_n<Base>(diff.data(), u.data(), v.data(), n);
+        for (auto k : {mpn::kernel::avx2, mpn::kernel::avx512}) {
+            if (!mpn::supports(k)) {
+                continue;
+            }
+            mpn::use_add_kernel(k);
+            std::vector<limb_t> res(n);
+            EXPECT_EQ(mpn::add_n<Base>(res.data(), u.data(), v.data(), n), carry) << mpn::kernel_name(k);
+            EXPECT_EQ(res, sum) << mpn::kernel_name(k) << ' ' << n;
+            EXPECT_EQ(mpn::sub_n<Base>(res.data(), u.data(), v.data(), n), borrow) << mpn::kernel_name(k);
+            EXPECT_EQ(res, diff) << mpn::kernel_name(k) << ' ' << n;
+            // in place, as the operators call them
+            res = u;
+            mpn::add_n<Base>(res.data(), res.data(), v.data(), n);
+            EXPECT_EQ(res, sum) << mpn::kernel_name(k);
+            res = v;
+            mpn::sub_n<Base>(res.data(), u.data(), res.data(), n);
+            EXPECT_EQ(res, diff) << mpn::kernel_name(k);
+        }
+    }
+}
+
+TEST_F(BigIntTest, VectorAddKernelsMatchPortable) {
+    EXPECT_TRUE(mpn::supports(mpn::add_kernel()));
+    if (mpn::supports(mpn::kernel::avx512)) {
+        EXPECT_EQ(mpn::add_kernel(), mpn::kernel::avx512);
+    }
+    EXPECT_THROW(mpn::use_add_kernel(static_cast<mpn::kernel>(-1)), std::invalid_argument);
+
+    KernelGuard guard;
+    std::mt19937_64 gen(23);
+    for (int i = 0; i < 20; ++i) {
+        check_add_kernels<10>(gen);
+        check_add_kernels<1000>(gen);
+        check_add_kernels<1000000000>(gen);
+        check_add_kernels<0>(gen);
+    }
+
+    // whole numbers through the operators on each kernel
+    BigInt x(random_digits(gen, 5000));
+    BigInt y(random_digits(gen, 3000));
+    mpn::use_add_kernel(mpn::kernel::portable);
+    BigInt sum = x + y;
+    BigInt diff = y - x;
+    for (auto k : {mpn::kernel::avx2, mpn::kernel::avx512}) {
+        if (mpn::supports(k)) {
+            mpn::use_add_kernel(k);
+            EXPECT_EQ(x + y, sum);
+            EXPECT_EQ(y - x, diff);
+            EXPECT_EQ(sum - y, x);
+        }
+    }
+}
+
+TEST_F(BigIntTest, MulxKernelsMatchPortable) {
+    using mpn::limb_t;
+    EXPECT_TRUE(mpn::supports(mpn::mul_kernel()));
+    if (mpn::supports(mpn::kernel::adx)) {
+        EXPECT_EQ(mpn::mul_kernel(), mpn::kernel::adx);
+    }
+    EXPECT_THROW(mpn::use_mul_kernel(mpn::kernel::avx2), std::invalid_argument);
+    EXPECT_THROW(mpn::use_add_kernel(mpn::kernel::adx), std::invalid_argument);
+
+    KernelGuard guard;
+    std::mt19937_64 gen(24);
+    const std::vector<mpn::kernel> kernels = {mpn::kernel::bmi2, mpn::kernel::adx};
+    for (size_t n : {0, 1, 3, 4, 5, 8, 9, 16, 33, 100, 1000}) {
+        for (int i = 0; i < 10; ++i) {
+            // all ones in every other round, where each carry is the largest
+            bool full = i % 2 == 1;
+            std::vector<limb_t> u(n);
+            std::vector<limb_t> acc(n);
+            for (size_t j = 0; j < n; ++j) {
+                u[j] = full ? ~limb_t{0} : gen();
+                acc[j] = full ? ~limb_t{0} : gen();
+            }
+            limb_t v = full ? ~limb_t{0} : gen();
+            mpn::use_mul_kernel(mpn::kernel::portable);
+            std::vector<limb_t> product(n);
+            std::vector<limb_t> sum = acc;
+            limb_t product_carry = mpn::mul_1<0>(product.data(), u.data(), n, v);
+            limb_t sum_carry = mpn::addmul_1<0>(sum.data(), u.data(), n, v);
+            for (auto k : kernels) {
+                if (!mpn::supports(k)) {
+                    continue;
+                }
+                mpn::use_mul_kernel(k);
+                std::vector<limb_t> res(n);
+                EXPECT_EQ(mpn::mul_1<0>(res.data(), u.data(), n, v), product_carry) << mpn::kernel_name(k);
+                EXPECT_EQ(res, product) << mpn::kernel_name(k) << ' ' << n;
+                res = u;
+                mpn::mul_1<0>(res.data(), res.data(), n, v);
+                EXPECT_EQ(res, product) << mpn::kernel_name(k) << ' ' << n;
+                res = acc;
+                EXPECT_EQ(mpn::addmul_1<0>(res.data(), u.data(), n, v), sum_carry) << mpn::kernel_name(k);
+                EXPECT_EQ(res, sum) << mpn::kernel_name(k) << ' ' << n;
+            }
+        }
+    }
+
+    // products and squares of binary limbs, in the basecase and through the tiers above it
+    using Binary = BasicBigInt<unsigned long long, 0>;
+    for (size_t digits : {19, 60, 250, 600, 3000, 20000}) {
+        Binary x(random_digits(gen, digits));
+        Binary y(random_digits(gen, digits / 2 + 1));
+        mpn::use_mul_kernel(mpn::kernel::portable);
+        Binary product = x * y;
+        Binary square = Binary::square(x);
+        for (auto k : kernels) {
+            if (mpn::supports(k)) {
+                mpn::use_mul_kernel(k);
+                EXPECT_EQ(x * y, product) << mpn::kernel_name(k) << ' ' << digits;
+                EXPECT_EQ(Binary::square(x), square) << mpn::kernel_name(k) << ' ' << digits;
+            }
+        }
+    }
+}
+
+TEST_F(BigIntTest, ToStringRoundTripsLongNumbers) {
+    std::mt19937_64 gen(14);
+    for (size_t digits : {18, 19, 20, 38, 462, 463, 1000, 4864, 12345, 60000}) {
+        std::string str = random_digits(gen, digits);
+        EXPECT_EQ(BigInt(str).to_string(), str);
+        EXPECT_EQ(BigInt("-" + str).to_string(), "-" + str);
+        // long runs of zeros in the middle are kept at every split
+        std::string sparse(digits + 2, '0');
+        sparse.front() = '7';
+        sparse.back() = '3';
+        EXPECT_EQ(BigInt(sparse).to_string(), sparse);
+        EXPECT_EQ(BigInt(std::string(digits, '9')).to_string(), std::string(digits, '9'));
+        std::string power(digits + 1, '0');
+        power[0] = '1';
+        EXPECT_EQ(BigInt(power).to_string(), power);
+    }
+    BigInt x = BigInt::pow(BigInt(2), 100000);
+    std::string str = x.to_string();
+    EXPECT_EQ(str.size(), 30103u);
+    EXPECT_EQ(str.substr(0, 10), "9990020930");
+    EXPECT_EQ(str.substr(str.size() - 10), "9883109376");
+}
+
+TEST_F(BigIntTest, ToCharsIntoCallerBuffer) {
+    char buf[64];
+    BigInt x("-1234567890123456789012345678901234567890");
+    auto res = x.to_chars(buf, buf + sizeof(buf));
+    EXPECT_EQ(res.ec, std::errc{});
+    EXPECT_EQ(std::string(buf, res.ptr), x.to_string());
+    // exactly enough room, then one character short
+    res = x.to_chars(buf, buf + 41);
+    EXPECT_EQ(res.ec, std::errc{});
+    EXPECT_EQ(res.ptr, buf + 41);
+    res = x.to_chars(buf, buf + 40);
+    EXPECT_EQ(res.ec, std::errc::value_too_large);
+    EXPECT_EQ(res.ptr, buf + 40);
+    res = BigInt(0).to_chars(buf, buf + 1);
+    EXPECT_EQ(std::string(buf, res.ptr), "0");
+}
+
+TEST_F(BigIntTest, FromCharsParsesLongestPrefix) {
+    BigInt x(7);
+    std::string_view str = "-12345678901234567890123,4";
+    auto res = x.from_chars(str);
+    EXPECT_EQ(res.ec, std::errc{});
+    EXPECT_EQ(res.ptr, str.data() + 24);
+    EXPECT_EQ(x, BigInt("-12345678901234567890123"));
+    res = x.from_chars(str.substr(25));
+    EXPECT_EQ(res.ptr, str.data() + 26);
+    EXPECT_EQ(x, BigInt(4));
+    EXPECT_EQ(x.from_chars("000000000000000000000000000000042xyz").ec, std::errc{});
+    EXPECT_EQ(x, BigInt(42));
+    EXPECT_EQ(x.from_chars("-0").ec, std::errc{});
+    EXPECT_EQ(x, BigInt(0));
+    // a failed parse leaves the value alone
+    for (std::string_view bad : {"", "-", "+1", "x1", "-x", " 1"}) {
+        res = x.from_chars(bad);
+        EXPECT_EQ(res.ec, std::errc::invalid_argument);
+        EXPECT_EQ(res.ptr, bad.data());
+        EXPECT_EQ(x, BigInt(0));
+    }
+    EXPECT_THROW(BigInt("12345678901234567890123456789 "), std::invalid_argument);
+    EXPECT_THROW(BigInt("1234567/"), std::invalid_argument);
+    EXPECT_THROW(BigInt("12345678:"), std::invalid_argument);
+}
+
+TEST_F(BigIntTest, FromCharsLongNumbers) {
+    for (uint64_t digits : {7, 8, 9, 16, 19, 20, 455, 456, 457, 1000, 9728, 33333}) {
+        BigInt power = BigInt::pow(BigInt(10), digits);
+        EXPECT_EQ(BigInt(std::string(digits, '9')), power - BigInt(1));
+        std::string str(digits + 1, '0');
+        str[0] = '3';
+        str.back() = '7';
+        EXPECT_EQ(BigInt(str), power * BigInt(3) + BigInt(7));
+        BigInt x;
+        EXPECT_EQ(x.from_chars("-" + str + "-").ec, std::errc{});
+        EXPECT_EQ(x, -(power * BigInt(3) + BigInt(7)));
+    }
+}
+
+TEST_F(BigIntTest, LongLongExtremes) {
+    EXPECT_EQ(BigInt(LLONG_MAX).to_string(), "9223372036854775807");
+    EXPECT_EQ(BigInt(LLONG_MIN).to_string(), "-9223372036854775808");
+    EXPECT_EQ(BigInt(LLONG_MIN) + BigInt(LLONG_MAX), BigInt(-1));
+}
+
+TEST_F(BigIntTest, PowersOfTwoAcrossLimbBoundaries) {
+    // 2^64 - 1, 2^64 and 2^128 sit on the edges of full binary limbs
+    BigInt two_64("18446744073709551616");
+    BigInt max_limb = two_64 - BigInt(1);
+    EXPECT_EQ(max_limb.to_string(), "18446744073709551615");
+    EXPECT_EQ((max_limb + BigInt(1)).to_string(), "18446744073709551616");
+    EXPECT_EQ((two_64 * two_64).to_string(), "340282366920938463463374607431768211456");
+    EXPECT_EQ((max_limb * max_limb).to_string(), "340282366920938463426481119284349108225");
+    EXPECT_EQ(two_64 * two_64 / max_limb, two_64 + BigInt(1));
+    EXPECT_EQ(two_64 * two_64 % max_limb, BigInt(1));
+    EXPECT_EQ(BigInt("10000000000000000000000000000000000000000").to_string(),
+              "10000000000000000000000000000000000000000");
+}
+
+BigInt naive_mod_exp(const BigInt &base, const BigInt &exp, const BigInt &mod) {
+    BigInt res = BigInt(1) % mod;
+    for (BigInt i(0); i < exp; ++i) {
+        res = res * base % mod;
+    }
+    return res;
+}
+
+TEST_F(BigIntTest, ModExpMatchesRepeatedMultiplication) {
+    std::mt19937_64 gen(10);
+    for (size_t mod_len : {1, 2, 9, 10, 19, 20, 40, 90}) {
+        for (int i = 0; i < 6; ++i) {
+            BigInt mod(random_digits(gen, mod_len));
+            BigInt base(random_digits(gen, mod_len + 3));
+            BigInt exp(static_cast<long long>(gen() % 40));
+            EXPECT_EQ(BigInt::mod_exp(base, exp, mod), naive_mod_exp(base, exp, mod));
+        }
+    }
+}
+
+TEST_F(BigIntTest, ModExpLargeExponents) {
+    // 2^127 - 1 is prime, so Fermat's little theorem applies
+    BigInt p("170141183460469231731687303715884105727");
+    BigInt a("123456789012345678901234567890");
+    EXPECT_EQ(BigInt::mod_exp(a, p - BigInt(1), p), BigInt(1));
+    EXPECT_EQ(BigInt::mod_exp(a, p, p), a);
+    // an even modulus takes the path without Montgomery form
+    BigInt even = p + BigInt(1);
+    EXPECT_EQ(BigInt::mod_exp(BigInt(3), BigInt(127), even), BigInt(3) * BigInt::mod_exp(BigInt(9), BigInt(63), even) % even);
+    EXPECT_EQ(BigInt::mod_exp(BigInt(2), BigInt(200), even), BigInt(0));
+}
+
+TEST_F(BigIntTest, ModExpHugeExponent) {
+    // a^e = a^(e mod (p - 1)) mod p for the prime p = 2^127 - 1
+    BigInt p("170141183460469231731687303715884105727");
+    BigInt e = BigInt::pow(BigInt(2), 100000) - BigInt(1);
+    BigInt a("98765432109876543210");
+    EXPECT_EQ(BigInt::mod_exp(a, e, p), BigInt::mod_exp(a, e % (p - BigInt(1)), p));
+    EXPECT_EQ(BigInt::mod_exp(a, e, p * BigInt(2)) % p, BigInt::mod_exp(a, e, p));
+}
+
+TEST_F(BigIntTest, ModExpSignsOfOperands) {
+    EXPECT_EQ(BigInt::mod_exp(BigInt(-2), BigInt(3), BigInt(-5)), BigInt(3));
+    EXPECT_EQ(BigInt::mod_exp(BigInt(2), BigInt(3), BigInt(-5)), BigInt(3));
+    EXPECT_EQ(BigInt::mod_exp(BigInt(-2), BigInt(-3), BigInt(5)), BigInt(-3));
+    EXPECT_EQ(BigInt::mod_exp(BigInt(-5), BigInt(3), BigInt(5)), BigInt(0));
+    EXPECT_EQ(BigInt::mod_exp(BigInt(-2), BigInt(3), BigInt(6)), BigInt(-2));
+}
+
+TEST_F(BigIntTest, MontgomeryFormRoundTrip) {
+    std::mt19937_64 gen(11);
+    BigInt mod(random_digits(gen, 60) + "1");
+    BigInt::Montgomery ctx(mod);
+    for (int i = 0; i < 20; ++i) {
+        BigInt x(random_digits(gen, 1 + gen() % 70));
+        BigInt y(random_digits(gen, 1 + gen() % 60));
+        BigInt mx = ctx.to_montgomery(x);
+        EXPECT_EQ(ctx.from_montgomery(mx), x % mod);
+        EXPECT_EQ(ctx.from_montgomery(ctx.multiply(mx, ctx.to_montgomery(y))), x * y % mod);
+    }
+    EXPECT_EQ(ctx.from_montgomery(ctx.to_montgomery(-BigInt(7))), mod - BigInt(7));
+    EXPECT_THROW(BigInt::Montgomery(BigInt(10)), std::invalid_argument);
+    EXPECT_THROW(BigInt::Montgomery(BigInt(0)), std::invalid_argument);
+}
+
+TEST_F(BigIntTest, ReducerMatchesRemainder) {
+    std::mt19937_64 gen(12);
+    std::vector<BigInt> mods = {BigInt(1), BigInt(7), BigInt(-1000000007), BigInt("1" + std::string(90, '0')),
+                                BigInt(std::string(90, '9')), BigInt("1" + std::string(89, '0') + "1")};
+    for (int i = 0; i < 10; ++i) {
+        mods.emplace_back(random_digits(gen, 1 + gen() % 120));
+    }
+    for (const BigInt &mod : mods) {
+        BigInt::Reducer ctx(mod);
+        BigInt abs_mod = mod < BigInt(0) ? -BigInt(mod) : mod;
+        EXPECT_EQ(ctx.modulus(), abs_mod);
+        for (int i = 0; i < 20; ++i) {
+            BigInt x(random_digits(gen, 1 + gen() % 400));
+            EXPECT_EQ(ctx.reduce(x), x % abs_mod);
+            BigInt expected = (-x) % abs_mod;
+            if (expected < BigInt(0)) {
+                expected += abs_mod;
+            }
+            EXPECT_EQ(ctx.reduce(-x), expected);
+        }
+        EXPECT_EQ(ctx.reduce(BigInt(0)), BigInt(0));
+        EXPECT_EQ(ctx.reduce(mod), BigInt(0));
+    }
+    EXPECT_THROW(BigInt::Reducer(BigInt(0)), std::invalid_argument);
+}
+
+TEST_F(BigIntTest, ReducerModularHelpers) {
+    std::mt19937_64 gen(13);
+    for (int digits : {1, 9, 10, 40, 200}) {
+        BigInt mod(random_digits(gen, digits) + "3");
+        BigInt::Reducer ctx(mod);
+        for (int i = 0; i < 20; ++i) {
+            BigInt x = BigInt(random_digits(gen, digits + 1)) % mod;
+            BigInt y = BigInt(random_digits(gen, digits + 1)) % mod;
+            EXPECT_EQ(ctx.mul(x, y), x * y % mod);
+            EXPECT_EQ(ctx.add(x, y), (x + y) % mod);
+            EXPECT_EQ(ctx.sub(x, y), (x - y + mod) % mod);
+        }
+        BigInt top = mod - BigInt(1);
+        EXPECT_EQ(ctx.mul(top, top), BigInt(1));
+        EXPECT_EQ(ctx.add(top, top), top - BigInt(1));
+        EXPECT_EQ(ctx.sub(BigInt(0), top), BigInt(1));
+    }
+}
+
+TEST_F(BigIntTest, PowMatchesRepeatedMultiplication) {
+    for (long long base : {0LL, 1LL, -1LL, 2LL, -3LL, 10LL, 999999999LL, -1000000007LL}) {
+        BigInt expected(1);
+        for (uint64_t exp = 0; exp < 70; ++exp) {
+            EXPECT_EQ(BigInt::pow(BigInt(base), exp), expected);
+            expected *= BigInt(base);
+        }
+    }
+}
+
+TEST_F(BigIntTest, PowLargeExponents) {
+    EXPECT_EQ(BigInt::pow(BigInt(2), 100).to_string(), "1267650600228229401496703205376");
+    EXPECT_EQ(BigInt::pow(BigInt(10), 1000), BigInt("1" + std::string(1000, '0')));
+    EXPECT_EQ(BigInt::pow(BigInt(-7), 777), -BigInt::pow(BigInt(7), 777));
+    // windows reach across the whole 64-bit exponent
+    BigInt one = BigInt::pow(BigInt(-1), UINT64_MAX);
+    EXPECT_EQ(one, BigInt(-1));
+    BigInt x = BigInt::pow(BigInt(3), 5000);
+    EXPECT_EQ(BigInt::pow(x, 3), x * x * x);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();